@@ -0,0 +1,335 @@
+#if defined(HAVE_OPENCV)
+// 与 main.cpp 相同：MSYS2 mingw64 (msvcrt) 缺少 quick_exit/timespec_get，前置声明以满足 <cstdlib>/<ctime>
+extern "C" {
+    void quick_exit(int);
+    int at_quick_exit(void (*)(void));
+    struct timespec; int timespec_get(struct timespec*, int);
+}
+#endif
+#include "ab_compare.h"
+
+#if AB_COMPARE
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include "dynamic_log.h"
+#include "fixed_point.h"
+#include "frame_binarize_cv.h"
+#include "indexed_render.h"
+#include "processor.h"
+
+static const int AB_VIEW_SCALE = 2;         // 三个图像固定按 2 倍最近邻放大
+static const uint8_t AB_DIFF_INDEX = 6;     // 差异图里两路不同的像素（imo 未用的索引，显示为洋红）
+
+// 状态栏里比对的 watch 标志
+static const struct {
+    const char *name;
+    uint8_t watch_o::*field;
+} AB_WATCH_FIELDS[] = {
+    {"InLoop", &watch_o::InLoop},
+    {"OutLoop", &watch_o::OutLoop},
+    {"cross", &watch_o::cross_flag},
+    {"zebra", &watch_o::zebra_flag},
+    {"straight", &watch_o::Straight_flag},
+    {"curve", &watch_o::Curve_flag},
+};
+
+static const render_palette *ab_imo_palette() {
+    static const render_palette pal = [] { render_palette p; render_palette_imo(&p); return p; }();
+    return &pal;
+}
+
+static const render_palette *ab_diff_palette() {
+    static const render_palette pal = [] {
+        render_palette p;
+        render_palette_imo(&p);
+        p.rgb[AB_DIFF_INDEX][0] = 255;
+        p.rgb[AB_DIFF_INDEX][1] = 0;
+        p.rgb[AB_DIFF_INDEX][2] = 255;
+        return p;
+    }();
+    return &pal;
+}
+
+AbCompareWindow::AbCompareWindow()
+    : window(nullptr)
+    , diff_image(nullptr)
+    , diff_label(nullptr)
+    , pixbufs(6)
+{
+    // 默认 A 与主流水线一致，B 换一条补线算术路径
+    for (int i = 0; i < 2; ++i) {
+        Lane &lane = lanes[i];
+        lane.owner = this;
+        lane.params.threshold = FRAME_BINARIZE_THRESHOLD;
+        lane.params.scale = FRAME_BINARIZE_SCALE;
+        lane.params.linefix_q16 = i == 0 ? IMAGE_USE_Q16 : !IMAGE_USE_Q16;
+        lane.worker = std::thread(laneMain, &lane);
+    }
+}
+
+AbCompareWindow::~AbCompareWindow() {
+    // 控件随 GTK 销毁；这里只收回两路线程
+    for (Lane &lane : lanes) {
+        {
+            std::lock_guard<std::mutex> lock(lane.mutex);
+            lane.quit = true;
+        }
+        lane.wake.notify_one();
+        lane.worker.join();
+    }
+}
+
+void AbCompareWindow::show() {
+    if (!window) buildUI();
+    gtk_widget_show_all(window);
+    gtk_window_present(GTK_WINDOW(window));
+    visible.store(true, std::memory_order_relaxed);
+}
+
+void AbCompareWindow::buildUI() {
+    window = gtk_window_new(GTK_WINDOW_TOPLEVEL);
+    gtk_window_set_title(GTK_WINDOW(window), "A/B 对比");
+    gtk_container_set_border_width(GTK_CONTAINER(window), 8);
+    g_signal_connect(window, "delete-event", G_CALLBACK(onWindowDelete), this);
+
+    GtkWidget *hbox = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 8);
+    gtk_container_add(GTK_CONTAINER(window), hbox);
+    gtk_box_pack_start(GTK_BOX(hbox), buildLane(lanes[0], "A"), FALSE, FALSE, 0);
+    gtk_box_pack_start(GTK_BOX(hbox), buildLane(lanes[1], "B"), FALSE, FALSE, 0);
+
+    GtkWidget *diff_frame = gtk_frame_new("差异（洋红为 A、B 不同的像素，其余按 A 显示）");
+    GtkWidget *diff_box = gtk_box_new(GTK_ORIENTATION_VERTICAL, 4);
+    gtk_container_set_border_width(GTK_CONTAINER(diff_box), 4);
+    gtk_container_add(GTK_CONTAINER(diff_frame), diff_box);
+    diff_image = gtk_image_new();
+    gtk_widget_set_size_request(diff_image, IMAGE_W * AB_VIEW_SCALE, IMAGE_H * AB_VIEW_SCALE);
+    gtk_box_pack_start(GTK_BOX(diff_box), diff_image, FALSE, FALSE, 0);
+    diff_label = gtk_label_new("切换帧后开始对比");
+    gtk_label_set_xalign(GTK_LABEL(diff_label), 0.0f);
+    gtk_box_pack_start(GTK_BOX(diff_box), diff_label, FALSE, FALSE, 0);
+    gtk_box_pack_start(GTK_BOX(hbox), diff_frame, FALSE, FALSE, 0);
+}
+
+GtkWidget *AbCompareWindow::buildLane(Lane &lane, const char *title) {
+    GtkWidget *frame = gtk_frame_new(title);
+    GtkWidget *box = gtk_box_new(GTK_ORIENTATION_VERTICAL, 4);
+    gtk_container_set_border_width(GTK_CONTAINER(box), 4);
+    gtk_container_add(GTK_CONTAINER(frame), box);
+
+    GtkWidget *controls = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 4);
+    gtk_box_pack_start(GTK_BOX(box), controls, FALSE, FALSE, 0);
+    gtk_box_pack_start(GTK_BOX(controls), gtk_label_new("阈值:"), FALSE, FALSE, 0);
+    lane.threshold_spin = gtk_spin_button_new_with_range(0, 255, 1);
+    gtk_spin_button_set_value(GTK_SPIN_BUTTON(lane.threshold_spin), lane.params.threshold);
+    gtk_box_pack_start(GTK_BOX(controls), lane.threshold_spin, FALSE, FALSE, 0);
+
+    lane.scale_combo = gtk_combo_box_text_new();
+    gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(lane.scale_combo), "线性缩放");
+    gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(lane.scale_combo), "面积缩放");
+    gtk_combo_box_set_active(GTK_COMBO_BOX(lane.scale_combo), lane.params.scale == FRAME_SCALE_AREA ? 1 : 0);
+    gtk_box_pack_start(GTK_BOX(controls), lane.scale_combo, FALSE, FALSE, 0);
+
+    lane.linefix_combo = gtk_combo_box_text_new();
+    gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(lane.linefix_combo), "补线浮点");
+    gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(lane.linefix_combo), "补线Q16");
+    gtk_combo_box_set_active(GTK_COMBO_BOX(lane.linefix_combo), lane.params.linefix_q16 ? 1 : 0);
+    gtk_box_pack_start(GTK_BOX(controls), lane.linefix_combo, FALSE, FALSE, 0);
+
+    g_signal_connect(lane.threshold_spin, "value-changed", G_CALLBACK(onParamsChanged), &lane);
+    g_signal_connect(lane.scale_combo, "changed", G_CALLBACK(onParamsChanged), &lane);
+    g_signal_connect(lane.linefix_combo, "changed", G_CALLBACK(onParamsChanged), &lane);
+
+    lane.image = gtk_image_new();
+    gtk_widget_set_size_request(lane.image, IMAGE_W * AB_VIEW_SCALE, IMAGE_H * AB_VIEW_SCALE);
+    gtk_box_pack_start(GTK_BOX(box), lane.image, FALSE, FALSE, 0);
+    lane.status = gtk_label_new("-");
+    gtk_label_set_xalign(GTK_LABEL(lane.status), 0.0f);
+    gtk_box_pack_start(GTK_BOX(box), lane.status, FALSE, FALSE, 0);
+    return frame;
+}
+
+AbParams AbCompareWindow::readParams(Lane &lane) {
+    AbParams p;
+    p.threshold = (uint8_t)gtk_spin_button_get_value_as_int(GTK_SPIN_BUTTON(lane.threshold_spin));
+    p.scale = gtk_combo_box_get_active(GTK_COMBO_BOX(lane.scale_combo)) == 1 ? FRAME_SCALE_AREA : FRAME_SCALE_LINEAR;
+    p.linefix_q16 = gtk_combo_box_get_active(GTK_COMBO_BOX(lane.linefix_combo)) == 1 ? 1 : 0;
+    return p;
+}
+
+// 改了某一路的参数：只让这一路重跑最近一帧
+void AbCompareWindow::onParamsChanged(GtkWidget *widget, gpointer data) {
+    (void)widget;
+    Lane &lane = *static_cast<Lane *>(data);
+    AbCompareWindow *self = lane.owner;
+    const AbParams p = self->readParams(lane);
+    {
+        std::lock_guard<std::mutex> lock(lane.mutex);
+        lane.params = p;
+    }
+    if (self->last_job) self->post(lane, self->last_job);
+}
+
+gboolean AbCompareWindow::onWindowDelete(GtkWidget *widget, GdkEvent *event, gpointer data) {
+    (void)event;
+    AbCompareWindow *self = static_cast<AbCompareWindow *>(data);
+    self->visible.store(false, std::memory_order_relaxed);
+    gtk_widget_hide(widget);
+    return TRUE;
+}
+
+void AbCompareWindow::submitFrame(const cv::Mat &frame, int frame_index, const struct watch_o &start_watch) {
+    if (!active() || frame.empty()) return;
+    std::shared_ptr<Job> job = std::make_shared<Job>();
+    job->frame = frame;
+    job->frame_index = frame_index;
+    job->start_watch = start_watch;
+    post(std::move(job));
+}
+
+void AbCompareWindow::submitBinary(const uint8_t original[IMAGE_H][IMAGE_W], int frame_index,
+                                   const struct watch_o &start_watch) {
+    if (!active()) return;
+    std::shared_ptr<Job> job = std::make_shared<Job>();
+    memcpy(job->original, original, sizeof(job->original));
+    job->frame_index = frame_index;
+    job->start_watch = start_watch;
+    post(std::move(job));
+}
+
+void AbCompareWindow::post(std::shared_ptr<const Job> job) {
+    last_job = job;
+    post(lanes[0], job);
+    post(lanes[1], std::move(job));
+}
+
+// 放进信箱；这一路还没取走的旧帧直接被替换
+void AbCompareWindow::post(Lane &lane, std::shared_ptr<const Job> job) {
+    {
+        std::lock_guard<std::mutex> lock(lane.mutex);
+        lane.job = std::move(job);
+        lane.pending = true;
+    }
+    lane.wake.notify_one();
+}
+
+void AbCompareWindow::laneMain(Lane *lane) {
+    int last_index = -1;
+    struct watch_o before;      // last_index 帧处理前的 watch
+    memset(&before, 0, sizeof(before));
+    for (;;) {
+        std::shared_ptr<const Job> job;
+        AbParams params;
+        {
+            std::unique_lock<std::mutex> lock(lane->mutex);
+            lane->wake.wait(lock, [lane] { return lane->quit || lane->pending; });
+            if (lane->quit) return;
+            job = lane->job;
+            params = lane->params;
+            lane->pending = false;
+        }
+
+        const auto t0 = std::chrono::steady_clock::now();
+        if (job->frame.empty()) memcpy(original_bi_image, job->original, sizeof(original_bi_image));
+        else binarize_mat_to_original(job->frame, params.scale, params.threshold);
+
+        if (job->frame_index == last_index) watch = before;
+        else if (job->frame_index != last_index + 1) watch = job->start_watch;
+        before = watch;
+        last_index = job->frame_index;
+
+        pipeline_linefix_q16 = params.linefix_q16;
+        log_set_current_frame(job->frame_index);
+        memset(imo, 255, sizeof(imo));
+        process_original_to_imo(&original_bi_image[0][0], &imo[0][0], IMAGE_W, IMAGE_H);
+        DynamicLogManager::getInstance().takeFrameLogs(job->frame_index);  // 不在本线程累积
+
+        std::unique_ptr<Result> r(new Result());
+        r->job = std::move(job);
+        r->params = params;
+        memcpy(r->imo, imo, sizeof(r->imo));
+        r->watch = watch;
+        r->elapsed_us = (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - t0).count();
+        {
+            std::lock_guard<std::mutex> lock(lane->mutex);
+            lane->result = std::move(r);
+        }
+        AbCompareWindow *self = lane->owner;
+        if (!self->idle_pending.exchange(true)) g_idle_add(onResults, self);
+    }
+}
+
+gboolean AbCompareWindow::onResults(gpointer data) {
+    AbCompareWindow *self = static_cast<AbCompareWindow *>(data);
+    self->idle_pending.store(false);
+    self->refresh();
+    return G_SOURCE_REMOVE;
+}
+
+static void ab_show_indexed(GtkWidget *image, PixbufPool &pool, const uint8_t *src, const render_palette *pal) {
+    const int w = IMAGE_W * AB_VIEW_SCALE, h = IMAGE_H * AB_VIEW_SCALE;
+    GdkPixbuf *pb = pool.acquire(w, h);
+    if (!pb) return;
+    render_indexed_rgb24(src, IMAGE_W, IMAGE_H, IMAGE_W, pal,
+                         gdk_pixbuf_get_pixels(pb), w, h, gdk_pixbuf_get_rowstride(pb));
+    gtk_image_set_from_pixbuf(GTK_IMAGE(image), pb);
+    g_object_unref(pb);
+}
+
+// 取走两路的新结果并刷新；两路结果属于同一帧时才算差异
+void AbCompareWindow::refresh() {
+    if (!window) return;
+    char text[256];
+    for (Lane &lane : lanes) {
+        std::unique_ptr<Result> r;
+        {
+            std::lock_guard<std::mutex> lock(lane.mutex);
+            r = std::move(lane.result);
+        }
+        if (!r) continue;
+        lane.shown = std::move(r);
+        const Result &s = *lane.shown;
+        ab_show_indexed(lane.image, pixbufs, &s.imo[0][0], ab_imo_palette());
+        int n = snprintf(text, sizeof(text), "帧 %d  %u µs\n", s.job->frame_index, s.elapsed_us);
+        for (const auto &f : AB_WATCH_FIELDS) {
+            if (n < 0 || n >= (int)sizeof(text)) break;
+            n += snprintf(text + n, sizeof(text) - n, "%s=%u ", f.name, (unsigned)(s.watch.*f.field));
+        }
+        gtk_label_set_text(GTK_LABEL(lane.status), text);
+    }
+
+    const Result *a = lanes[0].shown.get();
+    const Result *b = lanes[1].shown.get();
+    if (!a || !b || a->job != b->job) {
+        gtk_label_set_text(GTK_LABEL(diff_label), "等待两路处理同一帧…");
+        return;
+    }
+    int differ = 0;
+    for (int y = 0; y < IMAGE_H; ++y) {
+        for (int x = 0; x < IMAGE_W; ++x) {
+            const uint8_t va = a->imo[y][x];
+            if (va != b->imo[y][x]) {
+                diff[y][x] = AB_DIFF_INDEX;
+                ++differ;
+            } else {
+                diff[y][x] = va == AB_DIFF_INDEX ? 255 : va;
+            }
+        }
+    }
+    ab_show_indexed(diff_image, pixbufs, &diff[0][0], ab_diff_palette());
+
+    std::string flags;
+    for (const auto &f : AB_WATCH_FIELDS) {
+        if (a->watch.*f.field == b->watch.*f.field) continue;
+        snprintf(text, sizeof(text), " %s(A=%u B=%u)", f.name,
+                 (unsigned)(a->watch.*f.field), (unsigned)(b->watch.*f.field));
+        flags += text;
+    }
+    snprintf(text, sizeof(text), "帧 %d  不同像素 %d\n状态差异:%s", a->job->frame_index, differ,
+             flags.empty() ? " 无" : flags.c_str());
+    gtk_label_set_text(GTK_LABEL(diff_label), text);
+}
+
+#endif // AB_COMPARE
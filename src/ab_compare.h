@@ -0,0 +1,120 @@
+#ifndef AB_COMPARE_H
+#define AB_COMPARE_H
+
+// A/B 对比需要每条线程各有一份流水线全局状态（PIPELINE_THREAD_LOCAL），否则不提供
+#if defined(HAVE_OPENCV) && defined(PIPELINE_THREAD_LOCAL)
+#define AB_COMPARE 1
+
+#include <gtk/gtk.h>
+#include <opencv2/opencv.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include "frame_binarize.h"
+#include "global_image_buffer.h"
+#include "image.h"
+#include "pixbuf_pool.h"
+
+// 一路流水线的可调参数
+struct AbParams {
+    uint8_t threshold;          // 二值化阈值
+    frame_scale_mode scale;     // 缩放方式
+    uint8_t linefix_q16;        // 补线算术路径（1=Q16.16 定点，0=浮点）
+};
+
+// A/B 对比窗口：同一帧交给两条流水线（两组参数）各跑一遍，并排显示 imo 与差异
+// - 每路一条常驻线程，流水线全局状态（watch、边线等）是该线程自己的一份，与界面线程和另一路互不干扰
+// - 两路与界面线程的处理同时进行；送帧只是把帧放进每路的信箱（只留最新一帧），界面线程不等结果。
+//   两路处理完通过 g_idle_add 交回，显示时再算差异，所以播放时每帧只多一次信箱替换
+// - 每路按帧号延续自己的状态：连续帧接着上一帧的 watch；同一帧重跑（改了参数）回到该帧处理前的 watch；
+//   其他跳转从界面线程处理该帧前的 watch 开始
+// - 归档帧已经二值化，阈值与缩放方式对其不起作用
+// - 两路的动态日志只丢弃，不进入日志面板
+class AbCompareWindow {
+public:
+    AbCompareWindow();
+    ~AbCompareWindow();
+
+    AbCompareWindow(const AbCompareWindow &) = delete;
+    AbCompareWindow &operator=(const AbCompareWindow &) = delete;
+
+    void show();
+
+    // 窗口开着才需要送帧（可在任意线程读）
+    bool active() const { return visible.load(std::memory_order_relaxed); }
+
+    // 送入第 frame_index 帧（从 1 开始）；start_watch 为界面线程处理该帧之前的 watch
+    // 解码帧：frame 须独占内存（不引用解码器缓冲），两路共用不复制
+    void submitFrame(const cv::Mat &frame, int frame_index, const struct watch_o &start_watch);
+    // 已二值化的帧（归档）
+    void submitBinary(const uint8_t original[IMAGE_H][IMAGE_W], int frame_index, const struct watch_o &start_watch);
+
+private:
+    struct Job {
+        cv::Mat frame;                          // 为空时用 original
+        uint8_t original[IMAGE_H][IMAGE_W];
+        int frame_index;
+        struct watch_o start_watch;
+    };
+
+    struct Result {
+        std::shared_ptr<const Job> job;         // 用于判断两路结果是否同一帧
+        AbParams params;
+        uint8_t imo[IMAGE_H][IMAGE_W];
+        struct watch_o watch;
+        uint32_t elapsed_us;
+    };
+
+    struct Lane {
+        AbCompareWindow *owner = nullptr;
+
+        // 以下由 mutex 保护
+        std::mutex mutex;
+        std::condition_variable wake;
+        AbParams params;
+        std::shared_ptr<const Job> job;         // 信箱：最新一帧
+        bool pending = false;                   // 信箱里有未处理的任务
+        bool quit = false;
+        std::unique_ptr<Result> result;         // 最近一次结果（界面线程取走）
+
+        std::thread worker;
+
+        // 界面控件
+        GtkWidget *threshold_spin = nullptr;
+        GtkWidget *scale_combo = nullptr;
+        GtkWidget *linefix_combo = nullptr;
+        GtkWidget *image = nullptr;
+        GtkWidget *status = nullptr;
+        std::unique_ptr<Result> shown;          // 当前显示的结果（仅界面线程）
+    };
+
+    void buildUI();
+    GtkWidget *buildLane(Lane &lane, const char *title);
+    void post(Lane &lane, std::shared_ptr<const Job> job);
+    void post(std::shared_ptr<const Job> job);
+    void refresh();
+    AbParams readParams(Lane &lane);
+
+    static void laneMain(Lane *lane);
+    static gboolean onResults(gpointer data);
+    static void onParamsChanged(GtkWidget *widget, gpointer data);
+    static gboolean onWindowDelete(GtkWidget *widget, GdkEvent *event, gpointer data);
+
+    GtkWidget *window;
+    GtkWidget *diff_image;
+    GtkWidget *diff_label;
+    Lane lanes[2];
+    std::shared_ptr<const Job> last_job;        // 改参数时重跑（仅界面线程）
+    std::atomic<bool> visible{false};
+    std::atomic<bool> idle_pending{false};      // 已有一次 onResults 排队，合并通知
+    PixbufPool pixbufs;
+    uint8_t diff[IMAGE_H][IMAGE_W];
+};
+
+#else
+#define AB_COMPARE 0
+#endif
+
+#endif // AB_COMPARE_H
@@ -0,0 +1,120 @@
+#include "border_fit.h"
+
+// Σ_{i<k} i 与 Σ_{i<k} i² 的闭式公式
+static inline int32_t sum_i_below(int32_t k)  { return k * (k - 1) / 2; }
+static inline int32_t sum_i2_below(int32_t k) { return (k - 1) * k * (2 * k - 1) / 6; }
+
+// 由区间整数累加量求最小二乘斜率/截距
+// n：点数，si：Σi，si2：Σi²，sx：Σx，six：Σi·x
+static uint8_t fit_from_sums(int32_t n, int32_t si, int32_t si2, int32_t sx, int32_t six,
+                             float *slope, float *intercept)
+{
+    int64_t den = (int64_t)n * si2 - (int64_t)si * si;
+    if (n < 2 || den == 0) return 0;  // 单行无法确定斜率
+    int64_t num = (int64_t)n * six - (int64_t)si * sx;
+
+    float k = (float)num / (float)den;
+    if (slope) *slope = k;
+    if (intercept) *intercept = ((float)sx - k * (float)si) / (float)n;
+    return 1;
+}
+
+void border_prefix_build(border_prefix *prefix, const uint8_t *border)
+{
+    int32_t sx = 0, six = 0;
+    prefix->sum_x[0] = 0;
+    prefix->sum_ix[0] = 0;
+    for (int32_t i = 0; i < image_h; i++) {
+        sx += border[i];
+        six += i * border[i];
+        prefix->sum_x[i + 1] = sx;
+        prefix->sum_ix[i + 1] = six;
+    }
+}
+
+void border_fit_build_all(border_fits *fits)
+{
+    border_prefix_build(&fits->left, l_border);
+    border_prefix_build(&fits->right, r_border);
+    border_prefix_build(&fits->center, center_line);
+}
+
+// 定点版本：slope = num/den，intercept = (Σx - slope·Σi)/n，均为 Q16
+static uint8_t fit_from_sums_q16(int32_t n, int32_t si, int32_t si2, int32_t sx, int32_t six,
+                                 q16_t *slope, q16_t *intercept)
+{
+    int64_t den = (int64_t)n * si2 - (int64_t)si * si;
+    if (n < 2 || den == 0) return 0;
+    int64_t num = (int64_t)n * six - (int64_t)si * sx;
+
+    q16_t k = (q16_t)q16_round_div(num * Q16_ONE, den);
+    if (slope) *slope = k;
+    if (intercept) *intercept = (q16_t)q16_round_div((int64_t)sx * Q16_ONE - (int64_t)k * si, n);
+    return 1;
+}
+
+// 区间 [begin, end) 的整数累加量（前缀和相减）
+static uint8_t range_sums(const border_prefix *prefix, uint8_t begin, uint8_t end,
+                          int32_t *n, int32_t *si, int32_t *si2, int32_t *sx, int32_t *six)
+{
+    if (end > image_h) end = image_h;
+    if (begin >= end) return 0;
+
+    *n   = end - begin;
+    *si  = sum_i_below(end) - sum_i_below(begin);
+    *si2 = sum_i2_below(end) - sum_i2_below(begin);
+    *sx  = prefix->sum_x[end] - prefix->sum_x[begin];
+    *six = prefix->sum_ix[end] - prefix->sum_ix[begin];
+    return 1;
+}
+
+// 区间 [begin, end) 的整数累加量（直接遍历数组一次）
+static uint8_t array_sums(const uint8_t *border, uint8_t begin, uint8_t end,
+                          int32_t *n, int32_t *si, int32_t *si2, int32_t *sx, int32_t *six)
+{
+    if (begin >= end) return 0;
+
+    int32_t x = 0, ix = 0;
+    for (int32_t i = begin; i < end; i++) {
+        x += border[i];
+        ix += i * border[i];
+    }
+    *n   = end - begin;
+    *si  = sum_i_below(end) - sum_i_below(begin);
+    *si2 = sum_i2_below(end) - sum_i2_below(begin);
+    *sx  = x;
+    *six = ix;
+    return 1;
+}
+
+uint8_t border_fit_range(const border_prefix *prefix, uint8_t begin, uint8_t end,
+                         float *slope, float *intercept)
+{
+    int32_t n, si, si2, sx, six;
+    if (!range_sums(prefix, begin, end, &n, &si, &si2, &sx, &six)) return 0;
+    return fit_from_sums(n, si, si2, sx, six, slope, intercept);
+}
+
+uint8_t border_fit_array(const uint8_t *border, uint8_t begin, uint8_t end,
+                         float *slope, float *intercept)
+{
+    int32_t n, si, si2, sx, six;
+    if (!array_sums(border, begin, end, &n, &si, &si2, &sx, &six)) return 0;
+    return fit_from_sums(n, si, si2, sx, six, slope, intercept);
+}
+
+uint8_t border_fit_range_q16(const border_prefix *prefix, uint8_t begin, uint8_t end,
+                             q16_t *slope, q16_t *intercept)
+{
+    int32_t n, si, si2, sx, six;
+    if (!range_sums(prefix, begin, end, &n, &si, &si2, &sx, &six)) return 0;
+    return fit_from_sums_q16(n, si, si2, sx, six, slope, intercept);
+}
+
+uint8_t border_fit_array_q16(const uint8_t *border, uint8_t begin, uint8_t end,
+                             q16_t *slope, q16_t *intercept)
+{
+    int32_t n, si, si2, sx, six;
+    if (!array_sums(border, begin, end, &n, &si, &si2, &sx, &six)) return 0;
+    return fit_from_sums_q16(n, si, si2, sx, six, slope, intercept);
+}
@@ -0,0 +1,64 @@
+#ifndef BORDER_FIT_H
+#define BORDER_FIT_H
+
+/*
+  边线区间最小二乘拟合（前缀和版）
+
+  设计说明：
+  - 对 l_border / r_border / center_line 各建一次前缀和（O(image_h)），
+    之后任意行区间 [begin, end) 的斜率/截距查询均为 O(1)。
+  - 流水线本身不建前缀和：image_process 里没有区间拟合，本模块也没有全局状态。需要在同一帧上
+    做多次拟合的调用者（如 fixed_point_check）自备 border_fits，在边线定稿（补线、求中线）之后
+    调用 border_fit_build_all；只拟合一两次时直接用 border_fit_array。
+  - Σi、Σi² 用闭式公式计算，Σx、Σi·x 由前缀和相减得到，全程整数运算，无累计误差。
+  - 拟合模型与原 Slope_Calculate/calculate_s_i 一致：border[i] ≈ slope * i + intercept，
+    i 为自底向上的行号（与 l_border 下标相同）。
+  - 不保存任何“上一次结果”之类的隐藏状态：区间不足 2 行时返回 0，由调用者决定如何处理。
+*/
+
+#include <stdint.h>
+#include "image.h"
+#include "fixed_point.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* 单条边线的前缀和：下标 k 表示前 k 行 [0, k) 的累加 */
+typedef struct {
+    int32_t sum_x[image_h + 1];   /* Σ border[i] */
+    int32_t sum_ix[image_h + 1];  /* Σ i * border[i] */
+} border_prefix;
+
+/* 三条边线的前缀和，存储由调用者持有 */
+typedef struct {
+    border_prefix left;       /* l_border */
+    border_prefix right;      /* r_border */
+    border_prefix center;     /* center_line */
+} border_fits;
+
+/* 对长度为 image_h 的边线数组建立前缀和 */
+void border_prefix_build(border_prefix *prefix, const uint8_t *border);
+
+/* 按当前 l_border / r_border / center_line 建立三条线的前缀和 */
+void border_fit_build_all(border_fits *fits);
+
+/* O(1) 查询区间 [begin, end) 的最小二乘斜率与截距；区间不足 2 行返回 0 且不写出参 */
+uint8_t border_fit_range(const border_prefix *prefix, uint8_t begin, uint8_t end,
+                         float *slope, float *intercept);
+
+/* 不建前缀和、直接对数组区间做一次遍历的版本（单次循环，整数累加） */
+uint8_t border_fit_array(const uint8_t *border, uint8_t begin, uint8_t end,
+                         float *slope, float *intercept);
+
+/* 定点版本（Q16.16）：累加量与浮点版完全相同，仅最后的除法改为整数除法 */
+uint8_t border_fit_range_q16(const border_prefix *prefix, uint8_t begin, uint8_t end,
+                             q16_t *slope, q16_t *intercept);
+uint8_t border_fit_array_q16(const uint8_t *border, uint8_t begin, uint8_t end,
+                             q16_t *slope, q16_t *intercept);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BORDER_FIT_H */
@@ -156,6 +156,10 @@ LogRecord CSVReader::getLogByIndex(int index) const {
     return LogRecord(); // 返回空记录
 }
 
+const LogRecord* CSVReader::findLog(int index) const {
+    return (index >= 0 && index < (int)records.size()) ? &records[index] : nullptr;
+}
+
 void CSVReader::clear() {
     records.clear();
     variableNames.clear();
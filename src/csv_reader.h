@@ -25,11 +25,14 @@ public:
     // 根据索引获取日志记录
     LogRecord getLogByIndex(int index) const;
     
+    // 同上但不复制；越界返回 nullptr
+    const LogRecord* findLog(int index) const;
+    
     // 获取总记录数
     int getRecordCount() const { return records.size(); }
     
     // 获取所有变量名（CSV列标题中的自定义变量）
-    std::vector<std::string> getVariableNames() const { return variableNames; }
+    const std::vector<std::string>& getVariableNames() const { return variableNames; }
     
     // 清空数据
     void clear();
@@ -22,8 +22,15 @@ DynamicLogManager::~DynamicLogManager() {
     clearAll();
 }
 
+// 定义 PIPELINE_THREAD_LOCAL 时每条流水线线程各有一份日志（与算法全局状态一致），互不串帧
+#if defined(PIPELINE_THREAD_LOCAL)
+#define LOG_INSTANCE_STORAGE static thread_local
+#else
+#define LOG_INSTANCE_STORAGE static
+#endif
+
 DynamicLogManager& DynamicLogManager::getInstance() {
-    static DynamicLogManager instance;
+    LOG_INSTANCE_STORAGE DynamicLogManager instance;
     return instance;
 }
 
@@ -184,6 +191,29 @@ std::vector<DynamicLogVariable> DynamicLogManager::getFrameLogs(int frame_index)
     return std::vector<DynamicLogVariable>();
 }
 
+const std::vector<DynamicLogVariable>* DynamicLogManager::findFrameLogs(int frame_index) const {
+    auto it = frame_logs.find(frame_index);
+    return it != frame_logs.end() ? &it->second : nullptr;
+}
+
+std::vector<DynamicLogVariable> DynamicLogManager::takeFrameLogs(int frame_index) {
+    std::vector<DynamicLogVariable> vars;
+    auto it = frame_logs.find(frame_index);
+    if (it != frame_logs.end()) {
+        vars = std::move(it->second);
+        frame_logs.erase(it);
+    }
+    return vars;
+}
+
+void DynamicLogManager::setFrameLogs(int frame_index, std::vector<DynamicLogVariable> vars) {
+    if (vars.empty()) {
+        frame_logs.erase(frame_index);
+    } else {
+        frame_logs[frame_index] = std::move(vars);
+    }
+}
+
 void DynamicLogManager::clearAll() {
     frame_logs.clear();
 }
@@ -563,7 +593,7 @@ void log_set_csv_path(const char* csv_path) {
 }
 
 const char* log_get_csv_path() {
-    static std::string path;
+    LOG_INSTANCE_STORAGE std::string path;
     path = DynamicLogManager::getInstance().getCsvPath();
     return path.c_str();
 }
@@ -116,6 +116,15 @@ public:
     // 获取指定帧的所有日志变量
     std::vector<DynamicLogVariable> getFrameLogs(int frame_index) const;
     
+    // 同上但不复制；没有日志时返回 NULL，指针在该帧日志下一次被修改前有效
+    const std::vector<DynamicLogVariable>* findFrameLogs(int frame_index) const;
+    
+    // 取出指定帧的日志并从本实例删除（后台线程处理完一帧后交给界面线程）
+    std::vector<DynamicLogVariable> takeFrameLogs(int frame_index);
+    
+    // 以给定内容替换指定帧的日志（界面线程收下后台线程交来的日志）
+    void setFrameLogs(int frame_index, std::vector<DynamicLogVariable> vars);
+    
     // 清空所有日志
     void clearAll();
     
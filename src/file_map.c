@@ -0,0 +1,136 @@
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200112L  /* mmap / fstat */
+#endif
+#include "file_map.h"
+#include <string.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(_WIN32)
+static int utf8_to_wide(const char *s, wchar_t *out, int cap)
+{
+    return MultiByteToWideChar(CP_UTF8, 0, s, -1, out, cap) > 0 ? 0 : -1;
+}
+#endif
+
+FILE *file_open_utf8(const char *path, const char *mode)
+{
+#if defined(_WIN32)
+    wchar_t wpath[MAX_PATH * 2];
+    wchar_t wmode[8];
+    if (utf8_to_wide(path, wpath, MAX_PATH * 2) != 0 || utf8_to_wide(mode, wmode, 8) != 0) return NULL;
+    return _wfopen(wpath, wmode);
+#else
+    return fopen(path, mode);
+#endif
+}
+
+int file_replace_utf8(const char *from, const char *to)
+{
+#if defined(_WIN32)
+    wchar_t wfrom[MAX_PATH * 2];
+    wchar_t wto[MAX_PATH * 2];
+    if (utf8_to_wide(from, wfrom, MAX_PATH * 2) != 0 || utf8_to_wide(to, wto, MAX_PATH * 2) != 0) return -1;
+    return MoveFileExW(wfrom, wto, MOVEFILE_REPLACE_EXISTING) ? 0 : -1;
+#else
+    return rename(from, to) == 0 ? 0 : -1;
+#endif
+}
+
+int file_remove_utf8(const char *path)
+{
+#if defined(_WIN32)
+    wchar_t wpath[MAX_PATH * 2];
+    if (utf8_to_wide(path, wpath, MAX_PATH * 2) != 0) return -1;
+    return DeleteFileW(wpath) ? 0 : -1;
+#else
+    return remove(path) == 0 ? 0 : -1;
+#endif
+}
+
+int file_stamp_utf8(const char *path, uint64_t *size, int64_t *mtime)
+{
+#if defined(_WIN32)
+    wchar_t wpath[MAX_PATH * 2];
+    WIN32_FILE_ATTRIBUTE_DATA info;
+    if (utf8_to_wide(path, wpath, MAX_PATH * 2) != 0) return -1;
+    if (!GetFileAttributesExW(wpath, GetFileExInfoStandard, &info)) return -1;
+    *size = ((uint64_t)info.nFileSizeHigh << 32) | info.nFileSizeLow;
+    *mtime = (int64_t)(((uint64_t)info.ftLastWriteTime.dwHighDateTime << 32) | info.ftLastWriteTime.dwLowDateTime);
+    return 0;
+#else
+    struct stat st;
+    if (stat(path, &st) != 0) return -1;
+    *size = (uint64_t)st.st_size;
+    *mtime = (int64_t)st.st_mtime;
+    return 0;
+#endif
+}
+
+int file_map_open(file_map *m, const char *path, size_t min_size)
+{
+    memset(m, 0, sizeof(*m));
+#if defined(_WIN32)
+    wchar_t wpath[MAX_PATH * 2];
+    LARGE_INTEGER size;
+    if (utf8_to_wide(path, wpath, MAX_PATH * 2) != 0) return -1;
+    HANDLE file = CreateFileW(wpath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, NULL);
+    if (file == INVALID_HANDLE_VALUE) return -1;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0 || (size_t)size.QuadPart < min_size) {
+        CloseHandle(file);
+        return -1;
+    }
+    HANDLE map = CreateFileMappingW(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!map) {
+        CloseHandle(file);
+        return -1;
+    }
+    const void *base = MapViewOfFile(map, FILE_MAP_READ, 0, 0, 0);
+    if (!base) {
+        CloseHandle(map);
+        CloseHandle(file);
+        return -1;
+    }
+    m->base = (const uint8_t *)base;
+    m->size = (size_t)size.QuadPart;
+    m->os_file = file;
+    m->os_map = map;
+    return 0;
+#else
+    struct stat st;
+    const int fd = open(path, O_RDONLY);
+    if (fd < 0) return -1;
+    if (fstat(fd, &st) != 0 || st.st_size == 0 || (size_t)st.st_size < min_size) {
+        close(fd);
+        return -1;
+    }
+    void *base = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);  /* 映射建立后即可关闭描述符 */
+    if (base == MAP_FAILED) return -1;
+    m->base = (const uint8_t *)base;
+    m->size = (size_t)st.st_size;
+    return 0;
+#endif
+}
+
+void file_map_close(file_map *m)
+{
+    if (m->base) {
+#if defined(_WIN32)
+        UnmapViewOfFile(m->base);
+        CloseHandle((HANDLE)m->os_map);
+        CloseHandle((HANDLE)m->os_file);
+#else
+        munmap((void *)m->base, m->size);
+#endif
+    }
+    memset(m, 0, sizeof(*m));
+}
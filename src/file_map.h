@@ -0,0 +1,47 @@
+#ifndef FILE_MAP_H
+#define FILE_MAP_H
+
+/*
+  只读文件映射与 UTF-8 路径打开（桌面工具共用）
+
+  - file_map_open 在 POSIX 下用 mmap，在 Windows 下用 CreateFileMappingW；路径一律按 UTF-8 传入
+    （数据目录常带中文名，Windows 下不能走 ANSI API）。
+  - 映射建立后文件内容按需分页载入，随机访问任意偏移无需读盘拷贝。
+*/
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    const uint8_t *base;      /* 映射首地址，未打开时为 NULL */
+    size_t size;
+    void *os_file;            /* 平台句柄（Windows 下为文件与映射句柄） */
+    void *os_map;
+} file_map;
+
+/* 只读映射整个文件；文件短于 min_size 时视为失败。成功返回 0 */
+int file_map_open(file_map *m, const char *path, size_t min_size);
+void file_map_close(file_map *m);
+
+/* 按 UTF-8 路径打开文件（fopen 的 mode 语义） */
+FILE *file_open_utf8(const char *path, const char *mode);
+
+/* 按 UTF-8 路径把 from 改名为 to，to 已存在时覆盖。成功返回 0 */
+int file_replace_utf8(const char *from, const char *to);
+
+/* 按 UTF-8 路径删除文件。成功返回 0 */
+int file_remove_utf8(const char *path);
+
+/* 取文件大小与最后修改时间（平台相关的时间单位，只用于判断文件是否变过）。成功返回 0 */
+int file_stamp_utf8(const char *path, uint64_t *size, int64_t *mtime);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FILE_MAP_H */
@@ -0,0 +1,77 @@
+#ifndef FIXED_POINT_H
+#define FIXED_POINT_H
+
+/*
+  Q16.16 定点数小工具（斜率/截距与补线插值使用）
+
+  设计说明：
+  - q16_t 为有符号 32 位，低 16 位为小数；乘加中间量统一提升到 int64_t，避免溢出。
+  - 除法四舍五入到最近的 1/65536；最终转列坐标时与 C 的 float→int 一致（向零截断），
+    保证与浮点路径逐列可比。
+  - 编译期选择：定义 IMAGE_FIXED_POINT 时，流水线（补线、区间拟合）走定点路径，
+    单片机上不再逐行产生 FPU 运算；桌面默认仍走浮点路径。
+*/
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 199901L) || defined(__cplusplus)
+  #define FXP_INLINE static inline
+#else
+  #define FXP_INLINE static
+#endif
+
+typedef int32_t q16_t;
+
+#define Q16_SHIFT 16
+#define Q16_ONE   ((q16_t)1 << Q16_SHIFT)
+
+/* 编译期开关：1 = 定点路径，0 = 浮点路径 */
+#ifdef IMAGE_FIXED_POINT
+  #define IMAGE_USE_Q16 1
+#else
+  #define IMAGE_USE_Q16 0
+#endif
+
+/* 整数 → Q16 */
+FXP_INLINE q16_t q16_from_int(int32_t v) { return (q16_t)((int64_t)v * Q16_ONE); }
+
+/* 64 位整数除法，四舍五入到最近整数（den 为 0 时返回 0，由调用者保证不会出现） */
+FXP_INLINE int64_t q16_round_div(int64_t num, int64_t den)
+{
+    if (den == 0) return 0;
+    if (den < 0) { num = -num; den = -den; }
+    return num >= 0 ? (num + den / 2) / den : -((-num + den / 2) / den);
+}
+
+/* num/den → Q16（四舍五入到最近的 1/65536） */
+FXP_INLINE q16_t q16_div_int(int32_t num, int32_t den)
+{
+    return (q16_t)q16_round_div((int64_t)num * Q16_ONE, den);
+}
+
+/* Q16（以 int64 承载的中间量）→ 整数，向零截断 */
+FXP_INLINE int32_t q16_wide_to_int_trunc(int64_t v)
+{
+    return (int32_t)(v >= 0 ? (v >> Q16_SHIFT) : -((-v) >> Q16_SHIFT));
+}
+
+FXP_INLINE int32_t q16_to_int_trunc(q16_t v) { return q16_wide_to_int_trunc(v); }
+
+/* Q16 → float：桌面比对/日志，以及对外仍为 float 的拟合接口（Slope_Calculate 等）的返回值 */
+FXP_INLINE float q16_to_float(q16_t v) { return (float)v / (float)Q16_ONE; }
+
+/* trunc(x0 + k * n)：补线“点斜式”插值的定点实现，k 为 Q16 斜率 */
+FXP_INLINE int32_t q16_affine_trunc(int32_t x0, q16_t k, int32_t n)
+{
+    return q16_wide_to_int_trunc((int64_t)x0 * Q16_ONE + (int64_t)k * n);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FIXED_POINT_H */
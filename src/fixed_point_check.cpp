@@ -0,0 +1,195 @@
+#include <opencv2/opencv.hpp>
+#include <iostream>
+#include <filesystem>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstring>
+#include <cstdlib>
+#include <algorithm>
+#include "processor.h"
+#include "global_image_buffer.h"
+#include "border_fit.h"
+#include "fixed_point.h"
+#include "image.h"
+#include "frame_binarize_cv.h"
+
+namespace fs = std::filesystem;
+
+// 小契约：
+// 输入：若干 mp4 文件或目录（目录下递归查找 *.mp4，缺省为 data/），可选列容差 --tol N（默认 1 列）
+// 行为：逐帧跑现有流水线，然后在同一份边线上分别用浮点/Q16 定点两条路径做
+//       (1) 区间最小二乘拟合（预测区间两端的列）；(2) 各圆环状态下的 left_ring_linefix_on 补线
+//       并逐列比对
+// 输出：每个片段的比对统计；任一列差超过容差时退出码为 1
+
+struct CheckStats {
+    long frames = 0;
+    long fit_checks = 0;
+    long fit_mismatch = 0;   // 列差 > 0
+    long fit_over_tol = 0;   // 列差 > tol
+    int fit_max = 0;
+    long fix_rows = 0;
+    long fix_mismatch = 0;
+    long fix_over_tol = 0;
+    int fix_max = 0;
+    int first_bad_frame = -1;
+};
+
+// 列坐标差（uint8 边线存在回绕，按环形距离计）
+static int column_diff(int a, int b) {
+    int d = std::abs((a & 0xFF) - (b & 0xFF));
+    return d > 128 ? 256 - d : d;
+}
+
+static void record(CheckStats &st, int diff, int tol, int frame, bool is_fit) {
+    long &mismatch = is_fit ? st.fit_mismatch : st.fix_mismatch;
+    long &over = is_fit ? st.fit_over_tol : st.fix_over_tol;
+    int &mx = is_fit ? st.fit_max : st.fix_max;
+    if (diff > 0) ++mismatch;
+    if (diff > tol) {
+        ++over;
+        if (st.first_bad_frame < 0) st.first_bad_frame = frame;
+    }
+    mx = std::max(mx, diff);
+}
+
+// (1) 区间拟合：比较两条路径在区间首末行预测出的列
+static void check_fits(CheckStats &st, int tol, int frame) {
+    static const uint8_t ranges[][2] = {
+        {0, 40}, {20, 60}, {40, 80}, {60, 100}, {80, 120}, {0, 120}, {10, 30}, {50, 70}
+    };
+    border_fits fits;
+    border_fit_build_all(&fits);  // 本帧边线已定稿（process_original_to_imo 之后）
+    const border_prefix *lines[] = {&fits.left, &fits.right, &fits.center};
+    for (const border_prefix *line : lines) {
+        for (const auto &rg : ranges) {
+            float k = 0, b = 0;
+            q16_t kq = 0, bq = 0;
+            if (!border_fit_range(line, rg[0], rg[1], &k, &b)) continue;
+            if (!border_fit_range_q16(line, rg[0], rg[1], &kq, &bq)) continue;
+            const int rows[2] = {rg[0], rg[1] - 1};
+            for (int y : rows) {
+                int xf = (int)(b + k * (float)y);
+                int xq = q16_wide_to_int_trunc((int64_t)bq + (int64_t)kq * y);
+                ++st.fit_checks;
+                record(st, std::abs(xf - xq), tol, frame, true);
+            }
+        }
+    }
+}
+
+// (2) 补线：在当前帧边线上，依次模拟各圆环状态，比较两条路径的补线结果
+static void check_linefix(CheckStats &st, int tol, int frame) {
+    const struct watch_o saved = watch;
+
+    struct Scenario { int state; int angle2; int out_angle2; };
+    std::vector<Scenario> scenarios = {
+        {saved.InLoop, saved.InLoopAngle2, saved.OutLoopAngle2},  // 当前真实状态
+        {1, 120, 120},
+        {5, 120, 120},
+        {5, 120, 60},
+    };
+    for (int a2 = 70; a2 <= 110; a2 += 10) scenarios.push_back({2, a2, 120});
+
+    for (const Scenario &sc : scenarios) {
+        uint8_t lf[IMAGE_H], rf[IMAGE_H], lq[IMAGE_H], rq[IMAGE_H];
+        std::memcpy(lf, l_border, sizeof(lf));
+        std::memcpy(rf, r_border, sizeof(rf));
+        std::memcpy(lq, l_border, sizeof(lq));
+        std::memcpy(rq, r_border, sizeof(rq));
+
+        watch = saved;
+        watch.InLoop = (uint8_t)sc.state;
+        if (sc.state == 1) {
+            watch.InLoopAngleL = 0;
+            watch.InLoopCirc = 120;
+        }
+        watch.InLoopAngle2 = sc.angle2;
+        if (sc.state == 2) watch.InLoopAngle2_x = l_border[sc.angle2];
+        watch.OutLoopAngle2 = sc.out_angle2;
+        watch.zebra_flag = 0;
+        const struct watch_o scenario_watch = watch;
+
+        left_ring_linefix_on(lf, rf, 0);
+        watch = scenario_watch;
+        left_ring_linefix_on(lq, rq, 1);
+
+        for (int y = 0; y < IMAGE_H; ++y) {
+            st.fix_rows += 2;
+            record(st, column_diff(lf[y], lq[y]), tol, frame, false);
+            record(st, column_diff(rf[y], rq[y]), tol, frame, false);
+        }
+    }
+    watch = saved;
+}
+
+static void collect_clips(const fs::path &p, std::vector<fs::path> &out) {
+    std::error_code ec;
+    if (fs::is_directory(p, ec)) {
+        for (const auto &e : fs::recursive_directory_iterator(p, ec)) {
+            if (e.is_regular_file() && e.path().extension() == ".mp4") out.push_back(e.path());
+        }
+    } else if (fs::exists(p, ec)) {
+        out.push_back(p);
+    }
+}
+
+int main(int argc, char **argv) {
+    int tol = 1;
+    std::vector<fs::path> inputs;
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        if (a == "--tol" && i + 1 < argc) {
+            tol = std::atoi(argv[++i]);
+        } else if (a == "-h" || a == "--help") {
+            std::cerr << "用法: fixed_point_check [--tol N] [clip.mp4|目录]..." << std::endl;
+            std::cerr << "  --tol N  - 允许的最大列差（默认 1）" << std::endl;
+            std::cerr << "  目录     - 递归查找 *.mp4，缺省为 data/" << std::endl;
+            return 2;
+        } else {
+            inputs.push_back(a);
+        }
+    }
+    if (inputs.empty()) inputs.push_back("data");
+
+    std::vector<fs::path> clips;
+    for (const auto &p : inputs) collect_clips(p, clips);
+    std::sort(clips.begin(), clips.end());
+    if (clips.empty()) {
+        std::cerr << "错误: 未找到任何 mp4 片段" << std::endl;
+        return 1;
+    }
+
+    bool all_ok = true;
+    for (const auto &clip : clips) {
+        cv::VideoCapture cap(clip.string());
+        if (!cap.isOpened()) {
+            std::cerr << "错误: 无法打开视频: " << clip << std::endl;
+            all_ok = false;
+            continue;
+        }
+        CheckStats st;
+        cv::Mat frame;
+        while (cap.read(frame)) {
+            ++st.frames;
+            if (!binarize_mat_to_original(frame)) continue;
+            process_original_to_imo(&original_bi_image[0][0], &imo[0][0], IMAGE_W, IMAGE_H);
+            check_fits(st, tol, (int)st.frames);
+            check_linefix(st, tol, (int)st.frames);
+        }
+
+        const bool ok = (st.fit_over_tol == 0 && st.fix_over_tol == 0);
+        all_ok = all_ok && ok;
+        std::cout << (ok ? "[通过] " : "[失败] ") << clip.string() << std::endl;
+        std::cout << "  帧数: " << st.frames << std::endl;
+        std::cout << "  区间拟合: " << st.fit_checks << " 次, 不一致 " << st.fit_mismatch
+                  << ", 超容差 " << st.fit_over_tol << ", 最大列差 " << st.fit_max << std::endl;
+        std::cout << "  补线: " << st.fix_rows << " 列, 不一致 " << st.fix_mismatch
+                  << ", 超容差 " << st.fix_over_tol << ", 最大列差 " << st.fix_max << std::endl;
+        if (st.first_bad_frame >= 0) {
+            std::cout << "  首个超容差帧: " << st.first_bad_frame << std::endl;
+        }
+    }
+    return all_ok ? 0 : 1;
+}
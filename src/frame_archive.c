@@ -0,0 +1,157 @@
+#include "frame_archive.h"
+#include "morph_binary_bitpacked.h"
+#include <stdlib.h>
+#include <string.h>
+
+_Static_assert(sizeof(frame_archive_header) == FRAME_ARCHIVE_HEADER_BYTES, "归档头必须是 64 字节");
+
+/* ---------------- 写入 ---------------- */
+
+static void writer_release(frame_archive_writer *w)
+{
+    free(w->path);
+    w->path = NULL;
+    w->fp = NULL;
+}
+
+int frame_archive_create(frame_archive_writer *w, const char *path, int width, int height, uint32_t meta_bytes)
+{
+    memset(w, 0, sizeof(*w));
+    if (width <= 0 || width > FRAME_ARCHIVE_MAX_W || height <= 0 || height > 0xFFFF) return -1;
+    if (meta_bytes % 4 != 0) return -1;
+
+    memcpy(w->header.magic, FRAME_ARCHIVE_MAGIC, 4);
+    w->header.version = FRAME_ARCHIVE_VERSION;
+    w->header.header_bytes = FRAME_ARCHIVE_HEADER_BYTES;
+    w->header.width = (uint16_t)width;
+    w->header.height = (uint16_t)height;
+    w->header.frame_bytes = (uint32_t)total_words(width, height) * 4u;
+    w->header.meta_bytes = meta_bytes;
+
+    w->path = (char *)malloc(strlen(path) + 1);
+    if (!w->path) return -1;
+    strcpy(w->path, path);
+    w->fp = file_open_utf8(path, "wb");
+    if (!w->fp) {
+        writer_release(w);
+        return -1;
+    }
+    if (fwrite(&w->header, sizeof(w->header), 1, w->fp) != 1) {
+        fclose(w->fp);
+        file_remove_utf8(w->path);
+        writer_release(w);
+        return -1;
+    }
+    return 0;
+}
+
+void frame_archive_abort(frame_archive_writer *w)
+{
+    if (!w->fp) return;
+    fclose(w->fp);
+    file_remove_utf8(w->path);
+    writer_release(w);
+}
+
+static int write_meta(frame_archive_writer *w, const void *meta)
+{
+    static const uint8_t zeros[64];
+    uint32_t left = w->header.meta_bytes;
+    if (meta) return fwrite(meta, 1, left, w->fp) == left ? 0 : -1;
+    while (left > 0) {
+        const uint32_t n = left < sizeof(zeros) ? left : (uint32_t)sizeof(zeros);
+        if (fwrite(zeros, 1, n, w->fp) != n) return -1;
+        left -= n;
+    }
+    return 0;
+}
+
+int frame_archive_append_bits(frame_archive_writer *w, const uint32_t *bits, const void *meta)
+{
+    if (!w->fp) return -1;
+    if (fwrite(bits, 1, w->header.frame_bytes, w->fp) != w->header.frame_bytes) return -1;
+    if (write_meta(w, meta) != 0) return -1;
+    w->header.frame_count++;
+    return 0;
+}
+
+int frame_archive_append_u8(frame_archive_writer *w, const uint8_t *bin, int stride, const void *meta)
+{
+    uint32_t row[(FRAME_ARCHIVE_MAX_W + 31) / 32];
+    const int wpr = words_per_row(w->header.width);
+    if (!w->fp) return -1;
+    for (int y = 0; y < w->header.height; y++) {
+        pack_binary_u8_to_bits(bin + (size_t)y * stride, w->header.width, 1, stride, row);
+        if (fwrite(row, sizeof(uint32_t), (size_t)wpr, w->fp) != (size_t)wpr) return -1;
+    }
+    if (write_meta(w, meta) != 0) return -1;
+    w->header.frame_count++;
+    return 0;
+}
+
+int frame_archive_finish(frame_archive_writer *w)
+{
+    int rc = 0;
+    if (!w->fp) return -1;
+    if (fflush(w->fp) != 0) rc = -1;
+    if (fseek(w->fp, 0, SEEK_SET) != 0 || fwrite(&w->header, sizeof(w->header), 1, w->fp) != 1) rc = -1;
+    if (fclose(w->fp) != 0) rc = -1;
+    writer_release(w);
+    return rc;
+}
+
+/* ---------------- 读取 ---------------- */
+
+int frame_archive_open(frame_archive *a, const char *path)
+{
+    memset(a, 0, sizeof(*a));
+    if (file_map_open(&a->map, path, FRAME_ARCHIVE_HEADER_BYTES) != 0) return -1;
+
+    memcpy(&a->header, a->map.base, sizeof(a->header));
+    const frame_archive_header *h = &a->header;
+    if (memcmp(h->magic, FRAME_ARCHIVE_MAGIC, 4) != 0 || h->version != FRAME_ARCHIVE_VERSION
+        || h->header_bytes != FRAME_ARCHIVE_HEADER_BYTES || h->width == 0 || h->height == 0
+        || h->frame_bytes != (uint32_t)total_words(h->width, h->height) * 4u || h->meta_bytes % 4 != 0) {
+        frame_archive_close(a);
+        return -1;
+    }
+
+    a->record_bytes = (size_t)h->frame_bytes + h->meta_bytes;
+    const size_t complete = (a->map.size - FRAME_ARCHIVE_HEADER_BYTES) / a->record_bytes;
+    a->count = (h->frame_count != 0 && h->frame_count < complete) ? h->frame_count : (uint32_t)complete;
+    return 0;
+}
+
+void frame_archive_close(frame_archive *a)
+{
+    file_map_close(&a->map);
+    memset(a, 0, sizeof(*a));
+}
+
+const uint32_t *frame_archive_bits(const frame_archive *a, uint32_t i)
+{
+    if (!a->map.base || i >= a->count) return NULL;
+    return (const uint32_t *)(a->map.base + FRAME_ARCHIVE_HEADER_BYTES + (size_t)i * a->record_bytes);
+}
+
+const void *frame_archive_meta_ptr(const frame_archive *a, uint32_t i)
+{
+    if (!a->map.base || i >= a->count || a->header.meta_bytes == 0) return NULL;
+    return a->map.base + FRAME_ARCHIVE_HEADER_BYTES + (size_t)i * a->record_bytes + a->header.frame_bytes;
+}
+
+int frame_archive_read_meta(const frame_archive *a, uint32_t i, frame_archive_meta *out)
+{
+    const void *p = frame_archive_meta_ptr(a, i);
+    if (!p || a->header.meta_bytes < sizeof(*out)) return -1;
+    memcpy(out, p, sizeof(*out));
+    return 0;
+}
+
+int frame_archive_unpack_u8(const frame_archive *a, uint32_t i, uint8_t *dst, int dst_stride)
+{
+    const uint32_t *bits = frame_archive_bits(a, i);
+    if (!bits) return -1;
+    unpack_bits_to_binary_u8(bits, a->header.width, a->header.height, dst, dst_stride);
+    return 0;
+}
@@ -0,0 +1,103 @@
+#ifndef FRAME_ARCHIVE_H
+#define FRAME_ARCHIVE_H
+
+/*
+  位打包二值帧归档（.ipfa）
+
+  文件布局（小端）：
+    [0, 64)        frame_archive_header
+    之后逐帧定长记录：位图 frame_bytes 字节 + 元数据 meta_bytes 字节（meta_bytes 可为 0）
+  - 位图由 pack_binary_u8_to_bits 生成：每行 (width+31)/32 个 uint32，第 x 像素在第 x/32 个字的第 x%32 位，
+    bit=1 为白（255）；188×120 一帧 2880 字节。
+  - 记录定长，第 i 帧的偏移 = 64 + i * (frame_bytes + meta_bytes)，读取端 mmap 后 O(1) 定位、无需解码。
+  - frame_count 在写入端关闭时回填；写入中途异常退出时读取端按文件长度推算完整记录数。
+  - 元数据块对归档本身不透明；video_processor 写入 frame_archive_meta（帧号 + 时间戳）。
+*/
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "file_map.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FRAME_ARCHIVE_MAGIC        "IPFA"
+#define FRAME_ARCHIVE_VERSION      1
+#define FRAME_ARCHIVE_HEADER_BYTES 64
+#define FRAME_ARCHIVE_MAX_W        1024   /* 写入端逐行打包的行缓冲上限 */
+
+typedef struct {
+    char     magic[4];        /* "IPFA" */
+    uint16_t version;
+    uint16_t header_bytes;    /* 64 */
+    uint16_t width;
+    uint16_t height;
+    uint32_t frame_bytes;     /* 每帧位图字节数 */
+    uint32_t meta_bytes;      /* 每帧元数据字节数，4 的倍数，0 表示无 */
+    uint32_t frame_count;
+    uint32_t flags;           /* 保留，写 0 */
+    uint8_t  reserved[36];
+} frame_archive_header;
+
+/* video_processor 写入的标准元数据块 */
+typedef struct {
+    uint32_t frame_id;        /* 源视频中的帧号（从 1 开始） */
+    uint32_t flags;           /* 保留，写 0 */
+    int64_t  pts_us;          /* 源视频时间戳（微秒），未知为 -1 */
+} frame_archive_meta;
+
+/* ---------------- 写入 ---------------- */
+
+typedef struct {
+    FILE *fp;
+    char *path;               /* abort 时删除用 */
+    frame_archive_header header;
+} frame_archive_writer;
+
+/* 创建归档（覆盖已有文件）；path 为 UTF-8。成功返回 0 */
+int frame_archive_create(frame_archive_writer *w, const char *path, int width, int height, uint32_t meta_bytes);
+
+/* 追加一帧已打包位图；meta 为 meta_bytes 字节（可为 NULL，写 0） */
+int frame_archive_append_bits(frame_archive_writer *w, const uint32_t *bits, const void *meta);
+
+/* 追加一帧 0/非0 的 u8 二值图（逐行打包，不分配堆内存） */
+int frame_archive_append_u8(frame_archive_writer *w, const uint8_t *bin, int stride, const void *meta);
+
+/* 回填帧数并关闭；返回 0 表示全部写入成功 */
+int frame_archive_finish(frame_archive_writer *w);
+
+/* 放弃写入：关闭并删除归档文件（未 create 或已 finish 时什么也不做） */
+void frame_archive_abort(frame_archive_writer *w);
+
+/* ---------------- 读取（内存映射） ---------------- */
+
+typedef struct {
+    file_map map;             /* map.base 非空即已打开 */
+    frame_archive_header header;
+    uint32_t count;           /* 可用的完整帧数 */
+    size_t record_bytes;
+} frame_archive;
+
+/* 打开并映射归档；path 为 UTF-8。成功返回 0，格式不符或打不开返回 -1 */
+int frame_archive_open(frame_archive *a, const char *path);
+void frame_archive_close(frame_archive *a);
+
+/* 第 i 帧位图（指向映射内存，越界返回 NULL） */
+const uint32_t *frame_archive_bits(const frame_archive *a, uint32_t i);
+
+/* 第 i 帧元数据块（无元数据或越界返回 NULL） */
+const void *frame_archive_meta_ptr(const frame_archive *a, uint32_t i);
+
+/* 按标准布局读出元数据；meta_bytes 不足时返回 -1 */
+int frame_archive_read_meta(const frame_archive *a, uint32_t i, frame_archive_meta *out);
+
+/* 第 i 帧解包为 0/255 的 u8 图 */
+int frame_archive_unpack_u8(const frame_archive *a, uint32_t i, uint8_t *dst, int dst_stride);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FRAME_ARCHIVE_H */
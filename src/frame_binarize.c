@@ -0,0 +1,203 @@
+#include "frame_binarize.h"
+#include <string.h>
+
+#define LINEAR_BITS 11
+#define LINEAR_ONE  (1 << LINEAR_BITS)
+
+/* OpenCV COLOR_BGR2GRAY 的 14 位定点系数 */
+#define LUMA(r, g, b) ((uint32_t)((r) * 4899u + (g) * 9617u + (b) * 1868u + 8192u) >> 14)
+
+int frame_pixel_bytes(frame_pixel_format format)
+{
+    switch (format) {
+    case FRAME_FMT_GRAY8:  return 1;
+    case FRAME_FMT_BGR24:
+    case FRAME_FMT_RGB24:  return 3;
+    case FRAME_FMT_BGRA32:
+    case FRAME_FMT_RGBA32: return 4;
+    }
+    return 0;
+}
+
+static inline uint32_t luma_at(const uint8_t *p, frame_pixel_format format)
+{
+    switch (format) {
+    case FRAME_FMT_GRAY8:  return p[0];
+    case FRAME_FMT_BGR24:  return LUMA(p[2], p[1], p[0]);
+    case FRAME_FMT_RGB24:  return LUMA(p[0], p[1], p[2]);
+    case FRAME_FMT_BGRA32: return p[3] == 0 ? 255u : LUMA(p[2], p[1], p[0]);
+    case FRAME_FMT_RGBA32: return p[3] == 0 ? 255u : LUMA(p[0], p[1], p[2]);
+    }
+    return 0;
+}
+
+static int check_args(const frame_source *src, int dst_w, int dst_h)
+{
+    if (!src || !src->data) return -1;
+    if (src->width <= 0 || src->height <= 0 || frame_pixel_bytes(src->format) == 0) return -1;
+    if (src->stride < src->width * frame_pixel_bytes(src->format)) return -1;
+    if (dst_w <= 0 || dst_h <= 0 || dst_w > FRAME_BINARIZE_MAX_W) return -1;
+    return 0;
+}
+
+/* 双线性：像素中心对齐，越界按边缘夹取（与 INTER_LINEAR 的坐标换算相同） */
+static inline void linear_coord(int d, int dst_n, int src_n, int *s0, int *s1, uint32_t *a)
+{
+    int64_t pos = ((int64_t)(2 * d + 1) * src_n - dst_n) * LINEAR_ONE / (2 * (int64_t)dst_n);
+    if (pos < 0) pos = 0;
+    int i0 = (int)(pos >> LINEAR_BITS);
+    uint32_t frac = (uint32_t)(pos & (LINEAR_ONE - 1));
+    if (i0 >= src_n - 1) {
+        i0 = src_n - 1;
+        frac = 0;
+    }
+    *s0 = i0;
+    *s1 = (i0 + 1 < src_n) ? i0 + 1 : i0;
+    *a = frac;
+}
+
+/* 计算目标第 y 行的灰度（双线性） */
+static void linear_row(const frame_source *src, int y, int dst_w, int dst_h,
+                       const int16_t *xs0, const int16_t *xs1, const uint16_t *ax,
+                       uint8_t *gray)
+{
+    const int bpp = frame_pixel_bytes(src->format);
+    int y0, y1;
+    uint32_t ay;
+    linear_coord(y, dst_h, src->height, &y0, &y1, &ay);
+    const uint8_t *r0 = src->data + (size_t)y0 * src->stride;
+    const uint8_t *r1 = src->data + (size_t)y1 * src->stride;
+
+    for (int x = 0; x < dst_w; x++) {
+        const uint32_t wx1 = ax[x], wx0 = LINEAR_ONE - wx1;
+        const uint32_t top = luma_at(r0 + xs0[x] * bpp, src->format) * wx0
+                           + luma_at(r0 + xs1[x] * bpp, src->format) * wx1;
+        const uint32_t bot = luma_at(r1 + xs0[x] * bpp, src->format) * wx0
+                           + luma_at(r1 + xs1[x] * bpp, src->format) * wx1;
+        gray[x] = (uint8_t)((top * (LINEAR_ONE - ay) + bot * ay + (1u << (2 * LINEAR_BITS - 1)))
+                            >> (2 * LINEAR_BITS));
+    }
+}
+
+/*
+  计算目标第 y 行的灰度（面积平均）
+  以“源宽×目标宽”为公共单位：源像素 i 覆盖 [i*dst_w, (i+1)*dst_w)，目标像素 x 覆盖 [x*src_w, (x+1)*src_w)，
+  重叠长度即整数权重；每个目标像素的横向权重和为 src_w、纵向为 src_h。
+*/
+static void area_row(const frame_source *src, int y, int dst_w, int dst_h, uint8_t *gray)
+{
+    uint64_t acc[FRAME_BINARIZE_MAX_W];
+    const int bpp = frame_pixel_bytes(src->format);
+    const int64_t sw = src->width, sh = src->height;
+    memset(acc, 0, sizeof(acc[0]) * (size_t)dst_w);
+
+    const int64_t lo = (int64_t)y * sh, hi = lo + sh;
+    const int j0 = (int)(lo / dst_h), j1 = (int)((hi - 1) / dst_h);
+    for (int j = j0; j <= j1; j++) {
+        const int64_t top = (int64_t)j * dst_h, bottom = top + dst_h;
+        const uint64_t wy = (uint64_t)((bottom < hi ? bottom : hi) - (top > lo ? top : lo));
+        const uint8_t *row = src->data + (size_t)j * src->stride;
+
+        int x = 0;
+        int64_t cell_end = sw;
+        for (int i = 0; i < src->width; i++) {
+            const uint64_t g = luma_at(row + i * bpp, src->format) * wy;
+            int64_t p = (int64_t)i * dst_w;
+            const int64_t p_end = p + dst_w;
+            while (p < p_end) {
+                const int64_t seg = p_end < cell_end ? p_end : cell_end;
+                acc[x] += g * (uint64_t)(seg - p);
+                p = seg;
+                if (seg == cell_end) {
+                    x++;
+                    cell_end += sw;
+                }
+            }
+        }
+    }
+
+    const uint64_t den = (uint64_t)(sw * sh);
+    for (int x = 0; x < dst_w; x++) {
+        gray[x] = (uint8_t)((acc[x] + den / 2) / den);
+    }
+}
+
+/* 逐行产出灰度，交给 sink 写出（字节或位） */
+typedef void (*row_sink)(const uint8_t *gray, int y, int dst_w, uint8_t threshold, void *ctx);
+
+static int binarize_rows(const frame_source *src, frame_scale_mode mode, uint8_t threshold,
+                         int dst_w, int dst_h, row_sink sink, void *ctx)
+{
+    uint8_t gray[FRAME_BINARIZE_MAX_W];
+    int16_t xs0[FRAME_BINARIZE_MAX_W], xs1[FRAME_BINARIZE_MAX_W];
+    uint16_t ax[FRAME_BINARIZE_MAX_W];
+
+    if (check_args(src, dst_w, dst_h) != 0) return -1;
+
+    if (mode == FRAME_SCALE_AREA) {
+        for (int y = 0; y < dst_h; y++) {
+            area_row(src, y, dst_w, dst_h, gray);
+            sink(gray, y, dst_w, threshold, ctx);
+        }
+        return 0;
+    }
+
+    for (int x = 0; x < dst_w; x++) {
+        int s0, s1;
+        uint32_t a;
+        linear_coord(x, dst_w, src->width, &s0, &s1, &a);
+        xs0[x] = (int16_t)s0;
+        xs1[x] = (int16_t)s1;
+        ax[x] = (uint16_t)a;
+    }
+    for (int y = 0; y < dst_h; y++) {
+        linear_row(src, y, dst_w, dst_h, xs0, xs1, ax, gray);
+        sink(gray, y, dst_w, threshold, ctx);
+    }
+    return 0;
+}
+
+typedef struct {
+    uint8_t *dst;
+    int stride;
+} byte_sink_ctx;
+
+static void byte_sink(const uint8_t *gray, int y, int dst_w, uint8_t threshold, void *ctx)
+{
+    const byte_sink_ctx *c = (const byte_sink_ctx *)ctx;
+    uint8_t *out = c->dst + (size_t)y * c->stride;
+    for (int x = 0; x < dst_w; x++) {
+        out[x] = gray[x] > threshold ? 255 : 0;
+    }
+}
+
+static void bit_sink(const uint8_t *gray, int y, int dst_w, uint8_t threshold, void *ctx)
+{
+    const int wpr = (dst_w + 31) >> 5;
+    uint32_t *out = (uint32_t *)ctx + (size_t)y * wpr;
+    int x = 0;
+    for (int i = 0; i < wpr; i++) {
+        uint32_t w = 0;
+        for (int b = 0; b < 32 && x < dst_w; b++, x++) {
+            if (gray[x] > threshold) w |= (1u << b);
+        }
+        out[i] = w;
+    }
+}
+
+int frame_binarize(const frame_source *src, frame_scale_mode mode, uint8_t threshold,
+                   uint8_t *dst, int dst_w, int dst_h, int dst_stride)
+{
+    byte_sink_ctx ctx;
+    if (!dst || dst_stride < dst_w) return -1;
+    ctx.dst = dst;
+    ctx.stride = dst_stride;
+    return binarize_rows(src, mode, threshold, dst_w, dst_h, byte_sink, &ctx);
+}
+
+int frame_binarize_bits(const frame_source *src, frame_scale_mode mode, uint8_t threshold,
+                        uint32_t *dst_bits, int dst_w, int dst_h)
+{
+    if (!dst_bits) return -1;
+    return binarize_rows(src, mode, threshold, dst_w, dst_h, bit_sink, dst_bits);
+}
@@ -0,0 +1,66 @@
+#ifndef FRAME_BINARIZE_H
+#define FRAME_BINARIZE_H
+
+/*
+  融合的“取灰度 + 缩放 + 阈值（+ 可选位打包）”内核
+
+  设计说明：
+  - 一次遍历源帧，直接写入调用者给的缓冲区（通常是 original_bi_image），全程无堆分配；
+    每行的中间量放在栈上（目标宽度不超过 FRAME_BINARIZE_MAX_W）。
+  - 灰度：整数加权 (R*4899 + G*9617 + B*1868 + 8192) >> 14，与 OpenCV COLOR_BGR2GRAY 的定点系数一致。
+    带 alpha 的格式中 alpha==0 的像素按白色处理（与 GUI 原先的 pixbuf 二值化一致）。
+  - 缩放：
+      FRAME_SCALE_LINEAR：像素中心对齐的双线性（与 INTER_LINEAR / GDK_INTERP_BILINEAR 同一采样方式，11 位小数权重）；
+      FRAME_SCALE_AREA  ：精确的面积平均（权重为整数重叠长度），下采样时抗混叠。
+  - 阈值：灰度 > threshold 记为白（255/bit=1），否则黑（0/bit=0）。
+  - 位打包布局与 morph_binary_bitpacked 相同：每行 (dst_w+31)/32 个 uint32，第 x 像素在第 x/32 个字的第 x%32 位。
+*/
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FRAME_BINARIZE_MAX_W 1024   /* 目标宽度上限（栈上行缓冲） */
+
+typedef enum {
+    FRAME_FMT_GRAY8 = 0,
+    FRAME_FMT_BGR24,
+    FRAME_FMT_RGB24,
+    FRAME_FMT_BGRA32,
+    FRAME_FMT_RGBA32
+} frame_pixel_format;
+
+typedef enum {
+    FRAME_SCALE_LINEAR = 0,
+    FRAME_SCALE_AREA
+} frame_scale_mode;
+
+typedef struct {
+    const uint8_t *data;      /* 首行首像素 */
+    int width;
+    int height;
+    int stride;               /* 每行字节数 */
+    frame_pixel_format format;
+} frame_source;
+
+/* 每像素字节数 */
+int frame_pixel_bytes(frame_pixel_format format);
+
+/*
+  源帧 → dst_w×dst_h 的 0/255 二值图，dst_stride 为目标每行字节数
+  返回 0 成功；参数非法（尺寸 <= 0、目标过宽等）返回 -1 且不写目标
+*/
+int frame_binarize(const frame_source *src, frame_scale_mode mode, uint8_t threshold,
+                   uint8_t *dst, int dst_w, int dst_h, int dst_stride);
+
+/* 同上，但直接输出位打包结果（bit=1 为白），dst_bits 至少 dst_h * ((dst_w+31)/32) 个 uint32 */
+int frame_binarize_bits(const frame_source *src, frame_scale_mode mode, uint8_t threshold,
+                        uint32_t *dst_bits, int dst_w, int dst_h);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FRAME_BINARIZE_H */
@@ -0,0 +1,39 @@
+#ifndef FRAME_BINARIZE_CV_H
+#define FRAME_BINARIZE_CV_H
+
+// cv::Mat 与融合二值化内核之间的薄封装（仅在有 OpenCV 的目标中包含）
+
+#include <opencv2/opencv.hpp>
+#include "frame_binarize.h"
+#include "global_image_buffer.h"
+
+// 视频帧默认二值化参数（video_processor 与 GUI 共用）
+static const uint8_t FRAME_BINARIZE_THRESHOLD = 128;
+static const frame_scale_mode FRAME_BINARIZE_SCALE = FRAME_SCALE_LINEAR;
+
+// 8 位 1/3/4 通道（GRAY/BGR/BGRA）的 Mat 视为源帧；其他类型返回 false
+inline bool frame_source_from_mat(const cv::Mat &m, frame_source &src) {
+    if (m.empty() || m.depth() != CV_8U) return false;
+    switch (m.channels()) {
+    case 1: src.format = FRAME_FMT_GRAY8; break;
+    case 3: src.format = FRAME_FMT_BGR24; break;
+    case 4: src.format = FRAME_FMT_BGRA32; break;
+    default: return false;
+    }
+    src.data = m.ptr<uint8_t>(0);
+    src.width = m.cols;
+    src.height = m.rows;
+    src.stride = (int)m.step[0];
+    return true;
+}
+
+// 源帧直接缩放 + 二值化写入全局 original_bi_image（无中间 Mat、无堆分配）
+inline bool binarize_mat_to_original(const cv::Mat &m,
+                                     frame_scale_mode mode = FRAME_BINARIZE_SCALE,
+                                     uint8_t threshold = FRAME_BINARIZE_THRESHOLD) {
+    frame_source src;
+    if (!frame_source_from_mat(m, src)) return false;
+    return frame_binarize(&src, mode, threshold, &original_bi_image[0][0], IMAGE_W, IMAGE_H, IMAGE_W) == 0;
+}
+
+#endif // FRAME_BINARIZE_CV_H
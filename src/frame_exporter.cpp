@@ -0,0 +1,155 @@
+#include "frame_exporter.h"
+#include <chrono>
+#include <fstream>
+#include <utility>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+double elapsed_ms(std::chrono::steady_clock::time_point t0) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
+
+} // namespace
+
+FrameExporter::FrameExporter(const ExportOptions &opt) : opt_(opt) {
+    for (int i = 0; i < opt_.workers; ++i) {
+        pool_.emplace_back([this] { worker_loop(); });
+    }
+}
+
+FrameExporter::~FrameExporter() {
+    finish();
+}
+
+bool FrameExporter::submit(const fs::path &stem, cv::Mat image, int error_code) {
+    Job job;
+    job.stem = stem;
+    job.bytes = image.total() * image.elemSize();
+    job.image = std::move(image);
+    job.error_code = error_code;
+
+    if (pool_.empty()) {
+        if (failed()) return false;
+        encode_and_write(job);
+        return !failed();
+    }
+
+    const auto t0 = std::chrono::steady_clock::now();
+    std::unique_lock<std::mutex> lock(mutex_);
+    has_room_.wait(lock, [&] {
+        return closed_ || error_code_ != 0 || in_flight_ == 0 || in_flight_ + job.bytes <= opt_.budget_bytes;
+    });
+    stats_.stall_ms += elapsed_ms(t0);
+    if (closed_ || error_code_ != 0) return false;
+    in_flight_ += job.bytes;
+    jobs_.push_back(std::move(job));
+    lock.unlock();
+    has_job_.notify_one();
+    return true;
+}
+
+void FrameExporter::finish() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+    }
+    has_job_.notify_all();
+    has_room_.notify_all();
+    for (auto &t : pool_) t.join();
+    pool_.clear();
+}
+
+bool FrameExporter::failed() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return error_code_ != 0;
+}
+
+int FrameExporter::error_code() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return error_code_;
+}
+
+std::string FrameExporter::error_message() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return error_msg_;
+}
+
+ExportStats FrameExporter::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void FrameExporter::worker_loop() {
+    for (;;) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            has_job_.wait(lock, [this] { return closed_ || !jobs_.empty(); });
+            if (jobs_.empty()) return;
+            job = std::move(jobs_.front());
+            jobs_.pop_front();
+        }
+        if (!failed()) encode_and_write(job);  // 已出错：丢弃剩余任务
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            in_flight_ -= job.bytes;
+        }
+        has_room_.notify_all();
+    }
+}
+
+void FrameExporter::encode_and_write(const Job &job) {
+    std::string ext;
+    std::vector<int> params;
+    if (opt_.format == ExportFormat::Png) {
+        ext = ".png";
+        params = {cv::IMWRITE_PNG_COMPRESSION, opt_.png_level};
+    } else {
+        ext = job.image.channels() == 1 ? ".pgm" : ".ppm";
+        params = {cv::IMWRITE_PXM_BINARY, 1};
+    }
+    fs::path out = job.stem;
+    out += ext;
+
+    const auto t0 = std::chrono::steady_clock::now();
+    std::vector<unsigned char> buf;
+    bool ok = false;
+    try {
+        ok = cv::imencode(ext, job.image, buf, params);
+    } catch (const cv::Exception &) {
+        ok = false;
+    }
+    const double encode_ms = elapsed_ms(t0);
+    if (!ok) {
+        set_error(job.error_code, "编码失败: " + out.string());
+        return;
+    }
+
+    const auto t1 = std::chrono::steady_clock::now();
+    std::ofstream f(out, std::ios::binary | std::ios::trunc);
+    f.write(reinterpret_cast<const char *>(buf.data()), (std::streamsize)buf.size());
+    f.close();
+    const double write_ms = elapsed_ms(t1);
+    if (!f) {
+        set_error(job.error_code, "写入失败: " + out.string());
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.files += 1;
+    stats_.bytes += buf.size();
+    stats_.encode_ms += encode_ms;
+    stats_.write_ms += write_ms;
+}
+
+void FrameExporter::set_error(int code, const std::string &msg) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (error_code_ != 0) return;
+        error_code_ = code;
+        error_msg_ = msg;
+    }
+    has_room_.notify_all();
+}
@@ -0,0 +1,83 @@
+#ifndef FRAME_EXPORTER_H
+#define FRAME_EXPORTER_H
+
+#include <opencv2/opencv.hpp>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 帧导出阶段（video_processor 使用）
+// - 工作线程池做编码与写盘；workers=0 时在 submit() 里同步完成（--serial 对比用）
+// - 在途内存预算：排队 + 正在编码的图像字节数之和超过预算时 submit() 阻塞；
+//   单帧大于预算时只要没有其他在途帧仍然放行，避免死锁
+// - 格式：PNG（压缩级别 0~9）或无压缩的二进制 PGM/PPM（按通道数选扩展名）
+// - 出错后只保留第一个错误，之后的 submit() 返回 false，剩余任务直接丢弃
+
+enum class ExportFormat { Png, Pnm };
+
+struct ExportOptions {
+    ExportFormat format = ExportFormat::Png;
+    int png_level = 3;                       // IMWRITE_PNG_COMPRESSION
+    int workers = 1;
+    std::size_t budget_bytes = 256u << 20;   // 在途内存预算
+};
+
+struct ExportStats {
+    uint64_t files = 0;
+    uint64_t bytes = 0;        // 写出的文件字节数
+    double encode_ms = 0;      // 各线程编码耗时之和
+    double write_ms = 0;       // 各线程写盘耗时之和
+    double stall_ms = 0;       // submit() 等待预算的总时间
+};
+
+class FrameExporter {
+public:
+    explicit FrameExporter(const ExportOptions &opt);
+    ~FrameExporter();
+
+    FrameExporter(const FrameExporter &) = delete;
+    FrameExporter &operator=(const FrameExporter &) = delete;
+
+    // stem 为不带扩展名的输出路径；error_code 为该文件写失败时的退出码
+    bool submit(const std::filesystem::path &stem, cv::Mat image, int error_code);
+
+    // 等待所有在途任务完成并回收线程（可重复调用）
+    void finish();
+
+    bool failed() const;
+    int error_code() const;
+    std::string error_message() const;
+    ExportStats stats() const;
+
+private:
+    struct Job {
+        std::filesystem::path stem;
+        cv::Mat image;
+        int error_code = 0;
+        std::size_t bytes = 0;
+    };
+
+    void worker_loop();
+    void encode_and_write(const Job &job);
+    void set_error(int code, const std::string &msg);
+
+    const ExportOptions opt_;
+    mutable std::mutex mutex_;
+    std::condition_variable has_job_;
+    std::condition_variable has_room_;
+    std::deque<Job> jobs_;
+    std::size_t in_flight_ = 0;
+    bool closed_ = false;
+    int error_code_ = 0;
+    std::string error_msg_;
+    ExportStats stats_;
+    std::vector<std::thread> pool_;
+};
+
+#endif // FRAME_EXPORTER_H
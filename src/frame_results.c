@@ -0,0 +1,270 @@
+#include "frame_results.h"
+#include "image.h"
+#include "global_image_buffer.h"
+#include <stdlib.h>
+#include <string.h>
+
+_Static_assert(sizeof(frame_results_header) == FRAME_RESULTS_HEADER_BYTES, "结果头必须是 64 字节");
+_Static_assert(sizeof(frame_results_column) == 32, "列目录项必须是 32 字节");
+_Static_assert(FRAME_RESULTS_ROWS == image_h, "结果行数须与图像高度一致");
+
+#define COLUMN_ALIGN 64
+
+/* 写入端的列定义：列名即 frame_results_record 字段名 */
+typedef struct {
+    const char *name;
+    uint8_t type;
+    uint8_t elem_bytes;
+    uint16_t count;
+    size_t offset;   /* 在 frame_results_record 中的偏移 */
+} column_def;
+
+#define COL(field, type, ctype, n) { #field, type, (uint8_t)sizeof(ctype), n, offsetof(frame_results_record, field) }
+
+static const column_def k_columns[] = {
+    COL(frame_id,        FRAME_RESULTS_U32, uint32_t, 1),
+    COL(pts_us,          FRAME_RESULTS_I64, int64_t,  1),
+    COL(l_border,        FRAME_RESULTS_U8,  uint8_t,  FRAME_RESULTS_ROWS),
+    COL(r_border,        FRAME_RESULTS_U8,  uint8_t,  FRAME_RESULTS_ROWS),
+    COL(center_line,     FRAME_RESULTS_U8,  uint8_t,  FRAME_RESULTS_ROWS),
+    COL(left_lost_bits,  FRAME_RESULTS_U64, uint64_t, 2),
+    COL(right_lost_bits, FRAME_RESULTS_U64, uint64_t, 2),
+    COL(left_lost_num,   FRAME_RESULTS_U8,  uint8_t,  1),
+    COL(right_lost_num,  FRAME_RESULTS_U8,  uint8_t,  1),
+    COL(InLoop,          FRAME_RESULTS_U8,  uint8_t,  1),
+    COL(OutLoop,         FRAME_RESULTS_U8,  uint8_t,  1),
+    COL(cross_flag,      FRAME_RESULTS_U8,  uint8_t,  1),
+    COL(zebra_flag,      FRAME_RESULTS_U8,  uint8_t,  1),
+    COL(Straight_flag,   FRAME_RESULTS_U8,  uint8_t,  1),
+    COL(Curve_flag,      FRAME_RESULTS_U8,  uint8_t,  1),
+    COL(watch_lost,      FRAME_RESULTS_I32, int32_t,  1),
+    COL(top_x,           FRAME_RESULTS_I32, int32_t,  1),
+    COL(InLoopAngle2,    FRAME_RESULTS_I32, int32_t,  1),
+    COL(OutLoopAngle1,   FRAME_RESULTS_I32, int32_t,  1),
+    COL(OutLoopAngle2,   FRAME_RESULTS_I32, int32_t,  1),
+    COL(imo_hash,        FRAME_RESULTS_U64, uint64_t, 1),
+    COL(binarize_us,     FRAME_RESULTS_U32, uint32_t, 1),
+    COL(process_us,      FRAME_RESULTS_U32, uint32_t, 1),
+    COL(element_us,      FRAME_RESULTS_U32, uint32_t, 1),
+    COL(render_us,       FRAME_RESULTS_U32, uint32_t, 1),
+};
+
+#define COLUMN_COUNT (sizeof(k_columns) / sizeof(k_columns[0]))
+
+static uint64_t align_up(uint64_t v)
+{
+    return (v + COLUMN_ALIGN - 1) & ~(uint64_t)(COLUMN_ALIGN - 1);
+}
+
+uint64_t frame_results_hash(const void *data, size_t bytes)
+{
+    const uint8_t *p = (const uint8_t *)data;
+    uint64_t h = 0x9E3779B97F4A7C15ull ^ (uint64_t)bytes;
+    size_t i = 0;
+    for (; i + 8 <= bytes; i += 8) {
+        uint64_t v;
+        memcpy(&v, p + i, 8);
+        h = (h ^ v) * 0xFF51AFD7ED558CCDull;
+        h ^= h >> 32;
+    }
+    for (; i < bytes; i++) h = (h ^ p[i]) * 0x100000001B3ull;
+    h ^= h >> 29;
+    h *= 0xC4CEB9FE1A85EC53ull;
+    return h ^ (h >> 32);
+}
+
+void frame_results_capture(frame_results_record *r)
+{
+    memcpy(r->l_border, l_border, sizeof(r->l_border));
+    memcpy(r->r_border, r_border, sizeof(r->r_border));
+    memcpy(r->center_line, center_line, sizeof(r->center_line));
+    r->left_lost_bits = left_lost_bits;
+    r->right_lost_bits = right_lost_bits;
+    r->left_lost_num = watch.left_lost_num;
+    r->right_lost_num = watch.right_lost_num;
+    r->InLoop = watch.InLoop;
+    r->OutLoop = watch.OutLoop;
+    r->cross_flag = watch.cross_flag;
+    r->zebra_flag = watch.zebra_flag;
+    r->Straight_flag = watch.Straight_flag;
+    r->Curve_flag = watch.Curve_flag;
+    r->watch_lost = watch.watch_lost;
+    r->top_x = watch.top_x;
+    r->InLoopAngle2 = watch.InLoopAngle2;
+    r->OutLoopAngle1 = watch.OutLoopAngle1;
+    r->OutLoopAngle2 = watch.OutLoopAngle2;
+    r->imo_hash = frame_results_hash(imo, sizeof(imo));
+}
+
+/* ---------------- 写入 ---------------- */
+
+static void writer_release(frame_results_writer *w)
+{
+    free(w->rows);
+    free(w->path);
+    free(w->tmp_path);
+    memset(w, 0, sizeof(*w));
+}
+
+int frame_results_create(frame_results_writer *w, const char *path)
+{
+    const size_t len = strlen(path);
+    memset(w, 0, sizeof(*w));
+    w->path = (char *)malloc(len + 1);
+    w->tmp_path = (char *)malloc(len + 5);
+    if (!w->path || !w->tmp_path) {
+        writer_release(w);
+        return -1;
+    }
+    memcpy(w->path, path, len + 1);
+    memcpy(w->tmp_path, path, len);
+    memcpy(w->tmp_path + len, ".tmp", 5);
+    w->fp = file_open_utf8(w->tmp_path, "wb");
+    if (!w->fp) {
+        writer_release(w);
+        return -1;
+    }
+    return 0;
+}
+
+void frame_results_abort(frame_results_writer *w)
+{
+    if (!w->fp) return;
+    fclose(w->fp);
+    file_remove_utf8(w->tmp_path);
+    writer_release(w);
+}
+
+int frame_results_append(frame_results_writer *w, const frame_results_record *r)
+{
+    if (!w->fp) return -1;
+    if (w->count == w->capacity) {
+        const uint32_t cap = w->capacity ? w->capacity * 2 : 1024;
+        frame_results_record *rows = (frame_results_record *)realloc(w->rows, (size_t)cap * sizeof(*rows));
+        if (!rows) return -1;
+        w->rows = rows;
+        w->capacity = cap;
+    }
+    w->rows[w->count++] = *r;
+    return 0;
+}
+
+static int write_padding(FILE *fp, uint64_t from, uint64_t to)
+{
+    static const uint8_t zeros[COLUMN_ALIGN];
+    return (to - from) == 0 || fwrite(zeros, 1, (size_t)(to - from), fp) == (size_t)(to - from) ? 0 : -1;
+}
+
+/* 逐帧收集一列写出；列值在行内连续，按块拼好再 fwrite 以减少调用次数 */
+static int write_column(const frame_results_writer *w, const column_def *c)
+{
+    uint8_t buf[16 * 1024];
+    const size_t cell = (size_t)c->elem_bytes * c->count;
+    const size_t per_block = sizeof(buf) / cell;
+    for (uint32_t i = 0; i < w->count; ) {
+        size_t n = 0;
+        for (; n < per_block && i < w->count; n++, i++) {
+            memcpy(buf + n * cell, (const uint8_t *)&w->rows[i] + c->offset, cell);
+        }
+        if (fwrite(buf, cell, n, w->fp) != n) return -1;
+    }
+    return 0;
+}
+
+int frame_results_finish(frame_results_writer *w)
+{
+    frame_results_header h;
+    frame_results_column dir[COLUMN_COUNT];
+    int rc = 0;
+    if (!w->fp) return -1;
+
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, FRAME_RESULTS_MAGIC, 4);
+    h.version = FRAME_RESULTS_VERSION;
+    h.header_bytes = FRAME_RESULTS_HEADER_BYTES;
+    h.column_count = (uint32_t)COLUMN_COUNT;
+    h.frame_count = w->count;
+
+    uint64_t pos = align_up(FRAME_RESULTS_HEADER_BYTES + sizeof(dir));
+    memset(dir, 0, sizeof(dir));
+    for (size_t c = 0; c < COLUMN_COUNT; c++) {
+        strncpy(dir[c].name, k_columns[c].name, sizeof(dir[c].name) - 1);
+        dir[c].type = k_columns[c].type;
+        dir[c].elem_bytes = k_columns[c].elem_bytes;
+        dir[c].count = k_columns[c].count;
+        dir[c].offset = pos;
+        pos = align_up(pos + (uint64_t)w->count * k_columns[c].elem_bytes * k_columns[c].count);
+    }
+
+    if (fwrite(&h, sizeof(h), 1, w->fp) != 1 || fwrite(dir, sizeof(dir), 1, w->fp) != 1) rc = -1;
+    pos = FRAME_RESULTS_HEADER_BYTES + sizeof(dir);
+    for (size_t c = 0; c < COLUMN_COUNT && rc == 0; c++) {
+        if (write_padding(w->fp, pos, dir[c].offset) != 0 || write_column(w, &k_columns[c]) != 0) rc = -1;
+        pos = dir[c].offset + (uint64_t)w->count * k_columns[c].elem_bytes * k_columns[c].count;
+    }
+    if (fclose(w->fp) != 0) rc = -1;
+    if (rc == 0 && file_replace_utf8(w->tmp_path, w->path) != 0) rc = -1;
+    if (rc != 0) file_remove_utf8(w->tmp_path);
+    writer_release(w);
+    return rc;
+}
+
+/* ---------------- 读取 ---------------- */
+
+static int column_valid(const frame_results_column *c, uint32_t frames, size_t file_size)
+{
+    if (c->elem_bytes == 0 || c->count == 0 || c->offset % c->elem_bytes != 0) return 0;
+    const uint64_t bytes = (uint64_t)frames * c->elem_bytes * c->count;
+    return c->offset <= file_size && bytes <= file_size - c->offset;
+}
+
+int frame_results_open(frame_results *r, const char *path)
+{
+    memset(r, 0, sizeof(*r));
+    if (file_map_open(&r->map, path, FRAME_RESULTS_HEADER_BYTES) != 0) return -1;
+
+    memcpy(&r->header, r->map.base, sizeof(r->header));
+    const frame_results_header *h = &r->header;
+    const uint64_t dir_end = FRAME_RESULTS_HEADER_BYTES + (uint64_t)h->column_count * sizeof(frame_results_column);
+    if (memcmp(h->magic, FRAME_RESULTS_MAGIC, 4) != 0 || h->version != FRAME_RESULTS_VERSION
+        || h->header_bytes != FRAME_RESULTS_HEADER_BYTES || dir_end > r->map.size) {
+        frame_results_close(r);
+        return -1;
+    }
+    r->columns = (const frame_results_column *)(r->map.base + FRAME_RESULTS_HEADER_BYTES);
+    r->count = h->frame_count;
+    for (uint32_t c = 0; c < h->column_count; c++) {
+        if (!column_valid(&r->columns[c], r->count, r->map.size)) {
+            frame_results_close(r);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+void frame_results_close(frame_results *r)
+{
+    file_map_close(&r->map);
+    memset(r, 0, sizeof(*r));
+}
+
+const frame_results_column *frame_results_find(const frame_results *r, const char *name)
+{
+    if (!r->map.base) return NULL;
+    for (uint32_t c = 0; c < r->header.column_count; c++) {
+        if (strncmp(r->columns[c].name, name, sizeof(r->columns[c].name)) == 0) return &r->columns[c];
+    }
+    return NULL;
+}
+
+const void *frame_results_data(const frame_results *r, const frame_results_column *c)
+{
+    return (r->map.base && c) ? r->map.base + c->offset : NULL;
+}
+
+const void *frame_results_array(const frame_results *r, const char *name, int type, int count)
+{
+    const frame_results_column *c = frame_results_find(r, name);
+    if (!c || c->type != type || c->count != count) return NULL;
+    return frame_results_data(r, c);
+}
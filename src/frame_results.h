@@ -0,0 +1,147 @@
+#ifndef FRAME_RESULTS_H
+#define FRAME_RESULTS_H
+
+/*
+  逐帧算法结果列存（.ipfr）
+
+  文件布局（小端）：
+    [0, 64)                      frame_results_header
+    [64, 64 + 32 * column_count) 列目录 frame_results_column
+    之后各列数据依次存放，每列起始按 64 字节对齐；第 c 列第 i 帧的值位于
+      offset_c + i * elem_bytes_c * count_c
+  - 每帧一条定长记录 frame_results_record（边线、丢线位图、watch 主要字段、各阶段耗时），
+    写入端先按行缓存在内存中，finish 时转置成列写出（每帧约 470 字节，万帧约 4.5 MB）。
+  - 读取端 mmap 后按列名取到一段连续数组即可直接分析整段视频，无需解析、无需拷贝；
+    不认识的列直接忽略，新增列不破坏旧读取端。
+  - 写入中途异常退出时不会留下半个文件：先写到同目录的 "<path>.tmp"，finish 全部写成功后
+    再改名为 path（覆盖旧文件）；写失败或 abort 时删掉临时文件，path 上原有的文件不受影响。
+    进程被强行终止时最多留下 .tmp 文件。
+*/
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "file_map.h"
+#include "lost_bits.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FRAME_RESULTS_MAGIC        "IPFR"
+#define FRAME_RESULTS_VERSION      1
+#define FRAME_RESULTS_HEADER_BYTES 64
+#define FRAME_RESULTS_ROWS         120   /* 与 image_h 一致 */
+
+/* 列元素类型 */
+enum {
+    FRAME_RESULTS_U8 = 1,
+    FRAME_RESULTS_U32 = 2,
+    FRAME_RESULTS_I32 = 3,
+    FRAME_RESULTS_U64 = 4,
+    FRAME_RESULTS_I64 = 5
+};
+
+typedef struct {
+    char     magic[4];        /* "IPFR" */
+    uint16_t version;
+    uint16_t header_bytes;    /* 64 */
+    uint32_t column_count;
+    uint32_t frame_count;
+    uint8_t  reserved[48];
+} frame_results_header;
+
+typedef struct {
+    char     name[20];        /* 以 0 结尾的列名，与 frame_results_record 字段同名 */
+    uint8_t  type;            /* FRAME_RESULTS_* */
+    uint8_t  elem_bytes;
+    uint16_t count;           /* 每帧元素个数（边线列为 120） */
+    uint64_t offset;          /* 列数据在文件中的偏移 */
+} frame_results_column;
+
+/* 一帧的结果（写入端的行格式；列名即字段名） */
+typedef struct {
+    uint32_t  frame_id;                           /* 源视频帧号（从 1 开始） */
+    int64_t   pts_us;                             /* 源视频时间戳（微秒），未知为 -1 */
+    uint8_t   l_border[FRAME_RESULTS_ROWS];
+    uint8_t   r_border[FRAME_RESULTS_ROWS];
+    uint8_t   center_line[FRAME_RESULTS_ROWS];
+    lost_bits left_lost_bits;
+    lost_bits right_lost_bits;
+    uint8_t   left_lost_num;
+    uint8_t   right_lost_num;
+    uint8_t   InLoop;
+    uint8_t   OutLoop;
+    uint8_t   cross_flag;
+    uint8_t   zebra_flag;
+    uint8_t   Straight_flag;
+    uint8_t   Curve_flag;
+    int32_t   watch_lost;
+    int32_t   top_x;
+    int32_t   InLoopAngle2;
+    int32_t   OutLoopAngle1;
+    int32_t   OutLoopAngle2;
+    uint64_t  imo_hash;                           /* imo 整图哈希，比对两次运行的输出图是否一致 */
+    uint32_t  binarize_us;                        /* 缩放 + 二值化 */
+    uint32_t  process_us;                         /* process_original_to_imo */
+    uint32_t  element_us;                         /* 其中元素检测（PIPELINE_PROFILE 关闭时为 0） */
+    uint32_t  render_us;                          /* imo 上色 */
+} frame_results_record;
+
+/* 从算法全局状态（l_border / r_border / center_line / 丢线位图 / watch / imo）填充记录的算法字段；
+   帧号、时间戳与耗时由调用者填写 */
+void frame_results_capture(frame_results_record *r);
+
+/* 64 位内容哈希（按 8 字节块混合，非加密；只用于判断两帧输出是否相同） */
+uint64_t frame_results_hash(const void *data, size_t bytes);
+
+/* ---------------- 写入 ---------------- */
+
+typedef struct {
+    FILE *fp;                 /* 临时文件 */
+    char *path;               /* 最终路径 */
+    char *tmp_path;           /* path + ".tmp" */
+    frame_results_record *rows;
+    uint32_t count;
+    uint32_t capacity;
+} frame_results_writer;
+
+/* 创建结果文件（finish 成功后覆盖已有文件）；path 为 UTF-8。成功返回 0 */
+int frame_results_create(frame_results_writer *w, const char *path);
+
+/* 追加一帧（只写入内存缓存）；内存不足返回 -1 */
+int frame_results_append(frame_results_writer *w, const frame_results_record *r);
+
+/* 转置为列写出、关闭并改名为最终路径；返回 0 表示全部写入成功（失败时不留下任何文件） */
+int frame_results_finish(frame_results_writer *w);
+
+/* 放弃写入：关闭并删除临时文件，不动最终路径（未 create 或已 finish 时什么也不做） */
+void frame_results_abort(frame_results_writer *w);
+
+/* ---------------- 读取（内存映射） ---------------- */
+
+typedef struct {
+    file_map map;                         /* map.base 非空即已打开 */
+    frame_results_header header;
+    const frame_results_column *columns;  /* 指向映射内的列目录 */
+    uint32_t count;                       /* 帧数 */
+} frame_results;
+
+/* 打开并映射结果文件；path 为 UTF-8。成功返回 0，格式不符或打不开返回 -1 */
+int frame_results_open(frame_results *r, const char *path);
+void frame_results_close(frame_results *r);
+
+/* 按名查找列；找不到返回 NULL */
+const frame_results_column *frame_results_find(const frame_results *r, const char *name);
+
+/* 列数据首地址（count 帧 × count 个元素，连续存放） */
+const void *frame_results_data(const frame_results *r, const frame_results_column *c);
+
+/* 按名取列并校验元素类型与个数，不符返回 NULL；常用于 (const uint8_t *)frame_results_array(r, "l_border", FRAME_RESULTS_U8, 120) */
+const void *frame_results_array(const frame_results *r, const char *name, int type, int count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FRAME_RESULTS_H */
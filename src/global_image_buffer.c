@@ -1,8 +1,8 @@
 #include "global_image_buffer.h"
 
-uint8_t original_bi_image[IMAGE_H][IMAGE_W] = {0};
-uint8_t imo[IMAGE_H][IMAGE_W] = {0};
-uint8_t Grayscale[IMAGE_H][IMAGE_W] = {0};
+PIPELINE_TLS uint8_t original_bi_image[IMAGE_H][IMAGE_W] = {0};
+PIPELINE_TLS uint8_t imo[IMAGE_H][IMAGE_W] = {0};
+PIPELINE_TLS uint8_t Grayscale[IMAGE_H][IMAGE_W] = {0};
 
 void init_global_image_buffers_default(void)
 {
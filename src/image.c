@@ -7,6 +7,7 @@
 #include "global_image_buffer.h"
 #include "dynamic_log.h"
 #include "processor.h"
+#include "border_fit.h"
 
 // ---- 桌面环境桩：移除嵌入式依赖，提供最小可编译实现 ----
 // 若在嵌入式环境下已有这些外部符号，可在编译时定义以下宏以禁用本文件的桩：
@@ -16,7 +17,7 @@
 
 // 使用 global_image_buffer.h 中的全局数组
 // 显式初始化关键字段为 120，其余未列出字段默认置零
-struct watch_o watch = {
+PIPELINE_TLS struct watch_o watch = {
 	.InLoopAngle2 = 120,
 	.InLoopAngleL = 120,
 	.InLoopAngleR = 120,
@@ -84,8 +85,8 @@ int16_t limit1(int16_t x, int16_t y)
 备    注：
 example：  get_start_point(image_h-2)
  */
-uint8_t start_point_l[2] = { 0 };//左边起点的x，y值
-uint8_t start_point_r[2] = { 0 };//右边起点的x，y值
+PIPELINE_TLS uint8_t start_point_l[2] = { 0 };//左边起点的x，y值
+PIPELINE_TLS uint8_t start_point_r[2] = { 0 };//右边起点的x，y值
 uint8_t get_start_point(uint8_t start_row)
 {
 	uint16_t i = 0,l_found = 0,r_found = 0;
@@ -154,13 +155,13 @@ example：
 
 
  //存放点的x，y坐标
-uint16_t points_l[(uint16_t)USE_num][2] = { {  0 } };//左线
-uint16_t points_r[(uint16_t)USE_num][2] = { {  0 } };//右线
-uint16_t dir_r[(uint16_t)USE_num] = { 0 };//用来存储右边生长方向
-uint16_t dir_l[(uint16_t)USE_num] = { 0 };//用来存储左边生长方向
-uint16_t data_stastics_l = 0;//统计左边找到点的个数
-uint16_t data_stastics_r = 0;//统计右边找到点的个数
-uint8_t hightest = 0;//最高点
+PIPELINE_TLS uint16_t points_l[(uint16_t)USE_num][2] = { {  0 } };//左线
+PIPELINE_TLS uint16_t points_r[(uint16_t)USE_num][2] = { {  0 } };//右线
+PIPELINE_TLS uint16_t dir_r[(uint16_t)USE_num] = { 0 };//用来存储右边生长方向
+PIPELINE_TLS uint16_t dir_l[(uint16_t)USE_num] = { 0 };//用来存储左边生长方向
+PIPELINE_TLS uint16_t data_stastics_l = 0;//统计左边找到点的个数
+PIPELINE_TLS uint16_t data_stastics_r = 0;//统计右边找到点的个数
+PIPELINE_TLS uint8_t hightest = 0;//最高点
 void search_l_r(uint16_t break_flag, uint8_t(*image)[image_w], uint16_t *l_stastic, uint16_t *r_stastic, uint8_t l_start_x, uint8_t l_start_y, uint8_t r_start_x, uint8_t r_start_y, uint8_t *hightest)
 {
 
@@ -383,11 +384,11 @@ void search_l_r(uint16_t break_flag, uint8_t(*image)[image_w], uint16_t *l_stast
 函数名称：void get_left(uint16 total_L)
 功能说明：从八邻域边界里提取需要的边线
  */
-uint8_t l_border[image_h];//左线数组
-uint8_t r_border[image_h];//右线数组
-uint8_t center_line[image_h];//中线数组
-uint8_t left_lost[image_h];//左线丢失标志数组
-uint8_t right_lost[image_h];//右线丢失标志数组
+PIPELINE_TLS uint8_t l_border[image_h];//左线数组
+PIPELINE_TLS uint8_t r_border[image_h];//右线数组
+PIPELINE_TLS uint8_t center_line[image_h];//中线数组
+PIPELINE_TLS lost_bits left_lost_bits;//左线丢失标志位图
+PIPELINE_TLS lost_bits right_lost_bits;//右线丢失标志位图
 void get_left(uint16_t total_L)
 {
 	uint16_t j;
@@ -395,9 +396,8 @@ void get_left(uint16_t total_L)
 	for (j = 0; j < image_h; j++)
 	{
 		l_border[j] = border_min;
-		left_lost[j] = 1;  // 丢线标志
 	}
-	watch.left_lost_num=120;
+	lost_bits_fill(&left_lost_bits);  // 丢线标志
 	// 遍历所有找到的点，更新l_border数组（过程中反转行号）
 	for (j = 0; j < total_L; j++)
 	{
@@ -409,15 +409,14 @@ void get_left(uint16_t total_L)
 			if (col > l_border[row])
 			{
 				l_border[row] = col;
-				left_lost[row] = 0;
-				watch.left_lost_num--;
+				lost_bits_clear(&left_lost_bits, row);
 			}
 			else{//这里也没必要写
-				left_lost[row] = 1;  // 丢线标志
-				watch.left_lost_num++;
+				lost_bits_set(&left_lost_bits, row);  // 丢线标志
 			}
 		}
 	}
+	watch.left_lost_num = lost_bits_count(&left_lost_bits);
 }
 /*
 函数名称：void get_right(uint16 total_R)
@@ -436,9 +435,8 @@ void get_right(uint16_t total_R)
 	for (j = 0; j < image_h; j++)
 	{
 		r_border[j] = border_max;
-		right_lost[j] = 1;  // 丢线标志
 	}
-	watch.right_lost_num=120;
+	lost_bits_fill(&right_lost_bits);  // 丢线标志
 	// 遍历所有找到的点，更新r_border数组（过程中反转行号）
 	for (j = 0; j < total_R; j++)
 	{
@@ -451,15 +449,14 @@ void get_right(uint16_t total_R)
 			if (col < r_border[row])
 			{
 				r_border[row] = col;
-				right_lost[row] = 0;
-				watch.right_lost_num--;
+				lost_bits_clear(&right_lost_bits, row);
 			}
 			else{
-				right_lost[row] = 1;  // 丢线标志
-				watch.right_lost_num++;
+				lost_bits_set(&right_lost_bits, row);  // 丢线标志
 			}
 		}
 	}
+	watch.right_lost_num = lost_bits_count(&right_lost_bits);
 }
 
 /*
@@ -640,35 +637,21 @@ growth_array arr = {
 * @param uint8 end					输入终点
 * @param uint8 *border				输入需要计算斜率的边界首地址
 *  @see CTest		Slope_Calculate(start, end, border);//斜率
-* @return 返回说明
-*     -<em>false</em> fail
-*     -<em>true</em> succeed
+* @return 返回斜率；区间不足 2 行时返回 0
+* @note 一次遍历、整数累加；同一帧内需要多次拟合时由调用者建 border_fits（border_fit_build_all），再用 border_fit_range O(1) 查询
+*       定义 IMAGE_FIXED_POINT 时走 Q16 定点拟合，只在返回时转一次 float
 */
 float Slope_Calculate(uint8_t begin, uint8_t end, uint8_t *border)
 {
-	float xsum = 0, ysum = 0, xysum = 0, x2sum = 0;
-	int16_t i = 0;
+#if IMAGE_USE_Q16
+	q16_t result = 0;
+	border_fit_array_q16(border, begin, end, &result, NULL);
+	return q16_to_float(result);
+#else
 	float result = 0;
-	static float resultlast=0.0f;
-
-	for (i = begin; i < end; i++)
-	{
-		xsum += i;
-		ysum += border[i];
-		xysum += i * (border[i]);
-		x2sum += i * i;
-
-	}
-	if ((end - begin)*x2sum - xsum * xsum) //判断除数是否为零
-	{
-		result = ((end - begin)*xysum - xsum * ysum) / ((end - begin)*x2sum - xsum * xsum);
-		resultlast = result;
-	}
-	else
-	{
-		result = resultlast;
-	}
+	border_fit_array(border, begin, end, &result, NULL);
 	return result;
+#endif
 }
 
 /** 
@@ -685,33 +668,25 @@ float Slope_Calculate(uint8_t begin, uint8_t end, uint8_t *border)
 */
 void calculate_s_i(uint8_t start, uint8_t end, uint8_t *border, float *slope_rate, float *intercept)
 {
-	uint16_t i, num = 0;
-	uint16_t xsum = 0, ysum = 0;
-	float y_average, x_average;
-
-	num = 0;
-	xsum = 0;
-	ysum = 0;
-	y_average = 0;
-	x_average = 0;
-	for (i = start; i < end; i++)
-	{
-		xsum += i;
-		ysum += border[i];
-		num++;
-	}
-
-	//计算各个平均数
-	if (num)
+	uint8_t fitted;
+	*slope_rate = 0;
+	*intercept = 0;
+	// 斜率与截距由同一次遍历的累加量得出；定点路径同 Slope_Calculate
+#if IMAGE_USE_Q16
 	{
-		x_average = (float)xsum / (float)num;
-		y_average = (float)ysum / (float)num;
-
+		q16_t k = 0, b = 0;
+		fitted = border_fit_array_q16(border, start, end, &k, &b);
+		if (fitted)
+		{
+			*slope_rate = q16_to_float(k);
+			*intercept = q16_to_float(b);
+		}
 	}
-
-	/*计算斜率*/
-	*slope_rate = Slope_Calculate(start, end, border);//斜率
-	*intercept = y_average - (*slope_rate)*x_average;//截距
+#else
+	fitted = border_fit_array(border, start, end, slope_rate, intercept);
+#endif
+	// 只有一行时斜率为 0，截距取均值（即该行边线），与原实现一致
+	if (!fitted && end - start == 1) *intercept = border[start];
 }
 
 /** 
@@ -793,6 +768,10 @@ void userlog()
 	log_add_uint8("top_x", watch.top_x, -1);
 	log_add_uint8("left_lost_num", watch.left_lost_num, -1);
 	log_add_uint8("right_lost_num", watch.right_lost_num, -1);
+	// 日志仍按逐行 uint8 数组输出，保持原有日志格式
+	uint8_t left_lost[image_h], right_lost[image_h];
+	lost_bits_unpack(&left_lost_bits, left_lost, image_h);
+	lost_bits_unpack(&right_lost_bits, right_lost, image_h);
     log_add_uint8_array("right_lost", right_lost, sizeof(right_lost)/sizeof(right_lost[0]), -1);
     log_add_uint8_array("left_lost", left_lost, sizeof(left_lost)/sizeof(left_lost[0]), -1);
     log_add_uint8_array("l_border", l_border, sizeof(l_border)/sizeof(l_border[0]), -1);
@@ -813,26 +792,34 @@ void image_process(void)
 {
 	uint16_t i;
 	uint8_t Hightest = 0;//定义一个最高行，tip：这里的最高指的是y值的最小
+	PIPELINE_STAGE_BEGIN();//分阶段计时（仅 PIPELINE_PROFILE）
 
 //滤波（形态学处理）
 morph_clean_u8_binary_adapter(Grayscale[0], image_w, image_h, imo[0]);
 image_draw_rectan(imo);//填黑框
+PIPELINE_STAGE_MARK(PIPELINE_STAGE_MORPH);
 //清零
 data_stastics_l = 0;
 data_stastics_r = 0;
-if (get_start_point(image_h - 3)||get_start_point(image_h - 5)||get_start_point(image_h - 7))//找到起点了，再执行八领域，没找到就一直找
+const uint8_t found_start = get_start_point(image_h - 3)||get_start_point(image_h - 5)||get_start_point(image_h - 7);
+PIPELINE_STAGE_MARK(PIPELINE_STAGE_START_POINT);
+if (found_start)//找到起点了，再执行八领域，没找到就一直找
 {
 	//printf("正在开始八领域\n");
 	search_l_r((uint16_t)USE_num, imo, &data_stastics_l, &data_stastics_r, start_point_l[0], start_point_l[1], start_point_r[0], start_point_r[1], &hightest);
 	//printf("八邻域已结束\n");
+	PIPELINE_STAGE_MARK(PIPELINE_STAGE_SEARCH);
 	// 从爬取的边界线内提取边线 ， 这个才是最终有用的边线
 	get_left(data_stastics_l);
 	get_right(data_stastics_r);
+	PIPELINE_STAGE_MARK(PIPELINE_STAGE_GET_BORDER);
 	//处理函数放这里 不要放到if外面
     cross_fill(imo, l_border, r_border, data_stastics_l, data_stastics_r, dir_l, dir_r, points_l, points_r);//十字补线
+	PIPELINE_STAGE_MARK(PIPELINE_STAGE_CROSS_FILL);
 }
 	//补线
 	left_ring_linefix();
+	PIPELINE_STAGE_MARK(PIPELINE_STAGE_RING_LINEFIX);
     //求中线
 	for (i = Hightest; i < image_h-1; i++)
 	{
@@ -840,8 +827,10 @@ if (get_start_point(image_h - 3)||get_start_point(image_h - 5)||get_start_point(
 	}
     //显示边线
 	draw_edge();
+	PIPELINE_STAGE_MARK(PIPELINE_STAGE_DRAW_EDGE);
 
 	userlog();
+	PIPELINE_STAGE_MARK(PIPELINE_STAGE_USERLOG);
 }
 
 
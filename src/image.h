@@ -1,6 +1,13 @@
 #ifndef _IMAGE_H
 #define _IMAGE_H
 #include <stdint.h>
+#include "lost_bits.h"
+#include "pipeline_tls.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 //绘制边界线
 void draw_edge();
 
@@ -61,7 +68,7 @@ struct watch_o
 	
 	//圆环标志位
     uint8_t InLoopAngleL;  //入左环前直行的第一个角所在行（直道与圆环交接的角点）
-    int InLoopAngleR;  //入右环前直行的第一个角所在行（直道与圆环交接的角点）
+    uint8_t InLoopAngleR;  //入右环前直行的第一个角所在行（直道与圆环交接的角点）
     int InLoopCirc;   //圆环上凸弧
     int InLoopAngle2; //开始转向入环时前方的角点所在行（直道与圆环交接的角点）
     int InLoopAngle2_x;
@@ -93,7 +100,7 @@ struct watch_o
     uint8_t Midline_Lost_Count; //中线丢失行数
 };
 
-extern struct watch_o watch;
+extern PIPELINE_TLS struct watch_o watch;
 
 //宏定义
 #define image_h	120//图像高度
@@ -110,12 +117,17 @@ extern struct watch_o watch;
 
 extern void image_process(void); //直接在中断或循环里调用此程序就可以循环执行了
 
-extern uint8_t l_border[image_h];//左线数组
-extern uint8_t r_border[image_h];//右线数组
-extern uint8_t center_line[image_h];//中线数组
-extern uint8_t left_lost[image_h];//左线丢失标志数组
-extern uint8_t right_lost[image_h];//右线丢失标志数组
-extern uint16_t dir_r[(uint16_t)USE_num];//用来存储右边生长方向
-extern uint16_t dir_l[(uint16_t)USE_num];//用来存储左边生长方向
+extern PIPELINE_TLS uint8_t l_border[image_h];//左线数组
+extern PIPELINE_TLS uint8_t r_border[image_h];//右线数组
+extern PIPELINE_TLS uint8_t center_line[image_h];//中线数组
+extern PIPELINE_TLS lost_bits left_lost_bits;//左线丢失标志位图（第 y 位 = 第 y 行）
+extern PIPELINE_TLS lost_bits right_lost_bits;//右线丢失标志位图
+extern PIPELINE_TLS uint16_t dir_r[(uint16_t)USE_num];//用来存储右边生长方向
+extern PIPELINE_TLS uint16_t dir_l[(uint16_t)USE_num];//用来存储左边生长方向
+
+#ifdef __cplusplus
+}
+#endif
+
 #endif /*_IMAGE_H*/
 
@@ -0,0 +1,73 @@
+#include "imo_video_writer.h"
+#include <algorithm>
+#include <chrono>
+#include "global_image_buffer.h"
+
+ImoVideoWriter::~ImoVideoWriter() {
+    finish();
+}
+
+bool ImoVideoWriter::open(const ImoVideoOptions &opt) {
+    opt_ = opt;
+    if (opt_.scale < 1) opt_.scale = 1;
+    imo_size_ = cv::Size(IMAGE_W * opt_.scale, IMAGE_H * opt_.scale);
+    source_scaled_ = cv::Size();
+    if (opt_.side_by_side && opt_.source_size.width > 0 && opt_.source_size.height > 0) {
+        const int w = (int)((double)opt_.source_size.width * imo_size_.height / opt_.source_size.height + 0.5);
+        source_scaled_ = cv::Size(std::max(1, w), imo_size_.height);
+    }
+    frame_size_ = cv::Size(source_scaled_.width + imo_size_.width, imo_size_.height);
+
+    int fourcc = 0;
+    if (opt_.fourcc != "raw") {
+        if (opt_.fourcc.size() != 4) return false;
+        fourcc = cv::VideoWriter::fourcc(opt_.fourcc[0], opt_.fourcc[1], opt_.fourcc[2], opt_.fourcc[3]);
+    }
+    const double fps = opt_.fps > 0 ? opt_.fps : 25.0;
+    if (!writer_.open(opt_.path, fourcc, fps, frame_size_, true)) return false;
+
+    thread_ = std::thread([this] { run(); });
+    return true;
+}
+
+bool ImoVideoWriter::push(const cv::Mat &source, const cv::Mat &viz) {
+    Item item;
+    if (source_scaled_.width > 0) item.source = source;
+    item.viz = viz;
+    return queue_.push(std::move(item));
+}
+
+void ImoVideoWriter::finish() {
+    queue_.close();
+    if (thread_.joinable()) thread_.join();
+    if (writer_.isOpened()) writer_.release();
+}
+
+void ImoVideoWriter::compose(const Item &item, cv::Mat &out) const {
+    cv::Mat imo;
+    cv::resize(item.viz, imo, imo_size_, 0, 0, cv::INTER_NEAREST);
+    if (source_scaled_.width == 0) {
+        out = imo;
+        return;
+    }
+    cv::Mat bgr, scaled;
+    if (item.source.channels() == 1) {
+        cv::cvtColor(item.source, bgr, cv::COLOR_GRAY2BGR);
+    } else {
+        bgr = item.source;
+    }
+    cv::resize(bgr, scaled, source_scaled_, 0, 0, cv::INTER_AREA);
+    cv::hconcat(scaled, imo, out);
+}
+
+void ImoVideoWriter::run() {
+    Item item;
+    cv::Mat frame;
+    while (queue_.pop(item)) {
+        const auto t0 = std::chrono::steady_clock::now();
+        compose(item, frame);
+        writer_.write(frame);
+        encode_ms_ += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+        frames_.fetch_add(1);
+    }
+}
@@ -0,0 +1,68 @@
+#ifndef IMO_VIDEO_WRITER_H
+#define IMO_VIDEO_WRITER_H
+
+#include <opencv2/opencv.hpp>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include "bounded_queue.h"
+
+// imo 可视化视频输出（video_processor 的 --imo-video）
+// - 把上色后的 imo（可选与源帧左右拼接）写进单个视频/原始容器，代替逐帧 imo PNG
+// - 拼接、缩放与编码都在独立线程上完成；处理线程只投递 Mat 头（引用计数，不拷贝像素）
+// - 队列满时 push() 阻塞，编码跟不上时给处理线程施加背压
+// - fourcc 为 4 个字符（如 MJPG、FFV1、XVID），"raw" 表示不压缩（fourcc=0，需后端支持）
+
+struct ImoVideoOptions {
+    std::string path;
+    std::string fourcc = "MJPG";
+    double fps = 25.0;
+    int scale = 2;                 // imo 放大倍数（最近邻）
+    bool side_by_side = false;     // 左侧拼接源帧（缩放到同高）
+    cv::Size source_size;          // 源帧尺寸，side_by_side 时用于确定输出宽度
+};
+
+class ImoVideoWriter {
+public:
+    ImoVideoWriter() : queue_(16) {}
+    ~ImoVideoWriter();
+
+    ImoVideoWriter(const ImoVideoWriter &) = delete;
+    ImoVideoWriter &operator=(const ImoVideoWriter &) = delete;
+
+    // 打开输出并启动编码线程；失败返回 false
+    bool open(const ImoVideoOptions &opt);
+
+    // 投递一帧；source 仅在 side_by_side 时使用
+    // 只入队 Mat 头：投递后调用者不得再往这两个 Mat 的像素里写（下一帧要用新分配的 Mat）
+    bool push(const cv::Mat &source, const cv::Mat &viz);
+
+    // 等待队列写完并关闭文件（可重复调用）
+    void finish();
+
+    cv::Size frame_size() const { return frame_size_; }
+    uint64_t frames() const { return frames_.load(); }
+    double encode_ms() const { return encode_ms_; }   // finish() 之后读取
+
+private:
+    struct Item {
+        cv::Mat source;
+        cv::Mat viz;
+    };
+
+    void run();
+    void compose(const Item &item, cv::Mat &out) const;
+
+    ImoVideoOptions opt_;
+    cv::VideoWriter writer_;
+    BoundedQueue<Item> queue_;
+    std::thread thread_;
+    cv::Size imo_size_;
+    cv::Size source_scaled_;
+    cv::Size frame_size_;
+    std::atomic<uint64_t> frames_{0};
+    double encode_ms_ = 0;
+};
+
+#endif // IMO_VIDEO_WRITER_H
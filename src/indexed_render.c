@@ -0,0 +1,80 @@
+#include "indexed_render.h"
+#include <string.h>
+
+static void set_rgb(render_palette *pal, int v, uint32_t rgb)
+{
+    pal->rgb[v][0] = (uint8_t)(rgb >> 16);
+    pal->rgb[v][1] = (uint8_t)(rgb >> 8);
+    pal->rgb[v][2] = (uint8_t)rgb;
+}
+
+void render_palette_bw(render_palette *pal)
+{
+    memset(pal, 0xFF, sizeof(*pal));
+    set_rgb(pal, 0, 0x000000);
+}
+
+void render_palette_imo(render_palette *pal)
+{
+    memset(pal, 0xFF, sizeof(*pal));
+    set_rgb(pal, 0, 0x000000);
+    set_rgb(pal, 1, 0xFF0000);
+    set_rgb(pal, 2, 0xFFA500);
+    set_rgb(pal, 3, 0xFFFF00);
+    set_rgb(pal, 4, 0x00FF00);
+    set_rgb(pal, 5, 0x00FFFF);
+}
+
+/* 最近邻映射 d → d * src / dst 的反函数：源下标 s 覆盖的第一个目标下标 */
+static int first_dst(int s, int src, int dst)
+{
+    return (int)(((int64_t)s * dst + src - 1) / src);
+}
+
+void render_indexed_rgb24(const uint8_t *src, int src_w, int src_h, int src_stride,
+                          const render_palette *pal,
+                          uint8_t *dst, int dst_w, int dst_h, int dst_stride)
+{
+    if (!src || !dst || src_w <= 0 || src_h <= 0 || dst_w <= 0 || dst_h <= 0) return;
+    const size_t row_bytes = (size_t)dst_w * 3;
+
+    for (int sy = 0; sy < src_h; sy++) {
+        const int y0 = first_dst(sy, src_h, dst_h);
+        const int y1 = first_dst(sy + 1, src_h, dst_h);
+        if (y0 >= y1) continue;   /* 缩小时该源行没有对应的目标行 */
+
+        /* 展开一行：每个源像素写出等长的颜色段 */
+        const uint8_t *s = src + (size_t)sy * src_stride;
+        uint8_t *row = dst + (size_t)y0 * dst_stride;
+        uint8_t *p = row;
+        int x0 = 0;
+        for (int sx = 0; sx < src_w; sx++) {
+            const int x1 = first_dst(sx + 1, src_w, dst_w);
+            const uint8_t *c = pal->rgb[s[sx]];
+            for (int x = x0; x < x1; x++) {
+                p[0] = c[0];
+                p[1] = c[1];
+                p[2] = c[2];
+                p += 3;
+            }
+            x0 = x1;
+        }
+
+        /* 同一源行对应的其余目标行整行复制 */
+        for (int y = y0 + 1; y < y1; y++) {
+            memcpy(dst + (size_t)y * dst_stride, row, row_bytes);
+        }
+    }
+}
+
+void render_fit_size(int src_w, int src_h, int max_w, int max_h, int *out_w, int *out_h)
+{
+    double scale_w = (double)max_w / src_w;
+    double scale_h = (double)max_h / src_h;
+    double scale = scale_w < scale_h ? scale_w : scale_h;
+    if (scale < 0.1) scale = 0.1;
+    *out_w = (int)(src_w * scale);
+    *out_h = (int)(src_h * scale);
+    if (*out_w < 1) *out_w = 1;
+    if (*out_h < 1) *out_h = 1;
+}
@@ -0,0 +1,42 @@
+#ifndef INDEXED_RENDER_H
+#define INDEXED_RENDER_H
+
+/*
+  索引图（original / imo）→ RGB24 显示缓冲的渲染
+
+  设计说明：
+  - 每个像素值经 256 项调色板查表得到 RGB，取代逐像素 switch。
+  - 最近邻缩放直接渲染到最终显示尺寸：每个源行只展开一次（按源像素写出等长的颜色段），
+    该源行对应的其余目标行用 memcpy 整行复制；不再先按整数倍放大再做一次双线性缩放。
+  - 目标尺寸任意（可小于源尺寸），不分配内存，缓冲由调用者提供（GdkPixbuf 像素区等）。
+*/
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    uint8_t rgb[256][3];
+} render_palette;
+
+/* 二值图：0 为黑，其余为白 */
+void render_palette_bw(render_palette *pal);
+
+/* imo：0 黑、1 红、2 橙、3 黄、4 绿、5 青，其余（含 255）白 */
+void render_palette_imo(render_palette *pal);
+
+/* 把 src_w×src_h 的索引图（行跨度 src_stride 字节）按最近邻缩放渲染到 dst_w×dst_h 的 RGB24 缓冲 */
+void render_indexed_rgb24(const uint8_t *src, int src_w, int src_h, int src_stride,
+                          const render_palette *pal,
+                          uint8_t *dst, int dst_w, int dst_h, int dst_stride);
+
+/* 保持宽高比放进 max_w×max_h 的最大尺寸（缩放比下限 0.1，与界面原有的适配规则一致） */
+void render_fit_size(int src_w, int src_h, int max_w, int max_h, int *out_w, int *out_h);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INDEXED_RENDER_H */
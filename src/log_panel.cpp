@@ -0,0 +1,229 @@
+#include "log_panel.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+// 模型列
+enum LogPanelColumn {
+    COL_NAME,
+    COL_VALUE,
+    COL_WEIGHT,   // 值相对上一帧变化时加粗
+    COL_HEX,      // 值为原始 hex 串
+    COL_COUNT
+};
+
+static const int HEX_LINE_CHARS = 32;
+
+static const std::string NAME_UTF8 = "UTF-8文本";
+static const std::string NAME_HEX = "Hex数据";
+
+LogPanel::LogPanel()
+    : scroll(nullptr)
+    , tree_view(nullptr)
+    , store(nullptr)
+    , name_column(nullptr)
+    , value_renderer(nullptr)
+    , wrap_width(0)
+{
+    store = gtk_tree_store_new(COL_COUNT, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_INT, G_TYPE_BOOLEAN);
+    tree_view = gtk_tree_view_new_with_model(GTK_TREE_MODEL(store));
+    gtk_tree_view_set_headers_visible(GTK_TREE_VIEW(tree_view), FALSE);
+    gtk_tree_view_set_enable_search(GTK_TREE_VIEW(tree_view), FALSE);
+
+    GtkCellRenderer *name_renderer = gtk_cell_renderer_text_new();
+    name_column = gtk_tree_view_column_new_with_attributes("变量", name_renderer,
+                                                           "text", COL_NAME, NULL);
+    gtk_tree_view_append_column(GTK_TREE_VIEW(tree_view), name_column);
+
+    // 长数组与 hex 按面板宽度折行
+    value_renderer = gtk_cell_renderer_text_new();
+    g_object_set(value_renderer, "wrap-mode", PANGO_WRAP_CHAR, NULL);
+    GtkTreeViewColumn *value_column = gtk_tree_view_column_new();
+    gtk_tree_view_column_set_title(value_column, "值");
+    gtk_tree_view_column_pack_start(value_column, value_renderer, TRUE);
+    gtk_tree_view_column_add_attribute(value_column, value_renderer, "weight", COL_WEIGHT);
+    gtk_tree_view_column_set_cell_data_func(value_column, value_renderer, renderValue, NULL, NULL);
+    gtk_tree_view_append_column(GTK_TREE_VIEW(tree_view), value_column);
+
+    // 等宽字体（与原文本视图一致）
+    GtkCssProvider *provider = gtk_css_provider_new();
+    gtk_css_provider_load_from_data(provider,
+        "treeview { font-family: Monospace; font-size: 10pt; }", -1, NULL);
+    gtk_style_context_add_provider(
+        gtk_widget_get_style_context(tree_view),
+        GTK_STYLE_PROVIDER(provider),
+        GTK_STYLE_PROVIDER_PRIORITY_APPLICATION);
+    g_object_unref(provider);
+
+    // 不要水平滚动：值列宽度跟随面板，才能按宽度折行
+    scroll = gtk_scrolled_window_new(NULL, NULL);
+    gtk_scrolled_window_set_policy(GTK_SCROLLED_WINDOW(scroll), GTK_POLICY_NEVER, GTK_POLICY_AUTOMATIC);
+    gtk_container_add(GTK_CONTAINER(scroll), tree_view);
+    g_signal_connect(tree_view, "size-allocate", G_CALLBACK(onSizeAllocate), this);
+}
+
+LogPanel::~LogPanel() {
+    // 控件随主窗口销毁；这里只放掉构造时持有的模型引用
+    if (store) g_object_unref(store);
+}
+
+// 值列：hex 串在绘制时才按每行 32 字符格式化
+void LogPanel::renderValue(GtkTreeViewColumn *column, GtkCellRenderer *cell, GtkTreeModel *model,
+                           GtkTreeIter *iter, gpointer data) {
+    (void)column; (void)data;
+    gchar *value = NULL;
+    gboolean hex = FALSE;
+    gtk_tree_model_get(model, iter, COL_VALUE, &value, COL_HEX, &hex, -1);
+    if (hex && value) {
+        std::string text;
+        const size_t len = strlen(value);
+        text.reserve(len + len / HEX_LINE_CHARS + 1);
+        for (size_t i = 0; i < len; i += HEX_LINE_CHARS) {
+            if (i > 0) text += '\n';
+            text.append(value + i, std::min<size_t>(HEX_LINE_CHARS, len - i));
+        }
+        g_object_set(cell, "text", text.c_str(), NULL);
+    } else {
+        g_object_set(cell, "text", value ? value : "", NULL);
+    }
+    g_free(value);
+}
+
+// 折行宽度 = 面板宽度 - 名字列宽度；变化较大时才改，避免反复重排
+void LogPanel::onSizeAllocate(GtkWidget *widget, GdkRectangle *allocation, gpointer data) {
+    (void)widget;
+    LogPanel *self = static_cast<LogPanel*>(data);
+    const int width = allocation->width - gtk_tree_view_column_get_width(self->name_column) - 16;
+    if (width > 50 && std::abs(width - self->wrap_width) >= 8) {
+        self->wrap_width = width;
+        g_object_set(self->value_renderer, "wrap-width", width, NULL);
+    }
+}
+
+bool LogPanel::sectionExpanded(Section &sec) {
+    GtkTreePath *path = gtk_tree_model_get_path(GTK_TREE_MODEL(store), &sec.iter);
+    const bool expanded = gtk_tree_view_row_expanded(GTK_TREE_VIEW(tree_view), path);
+    gtk_tree_path_free(path);
+    return expanded;
+}
+
+void LogPanel::expandSection(Section &sec) {
+    GtkTreePath *path = gtk_tree_model_get_path(GTK_TREE_MODEL(store), &sec.iter);
+    gtk_tree_view_expand_row(GTK_TREE_VIEW(tree_view), path, FALSE);
+    gtk_tree_path_free(path);
+}
+
+// 变量集合变了：删掉该组全部子行再按新顺序追加
+void LogPanel::rebuildRows(Section &sec, const std::vector<Item> &new_items) {
+    // 子行全删后 TreeView 会把该组收起，先记下用户的展开状态
+    if (!sec.rows.empty()) sec.expanded = sectionExpanded(sec);
+    for (Row &row : sec.rows) gtk_tree_store_remove(store, &row.iter);
+    sec.rows.clear();
+    sec.rows.reserve(new_items.size());
+    for (const Item &item : new_items) {
+        Row row;
+        row.name = *item.name;
+        row.value = *item.value;
+        row.bold = false;
+        gtk_tree_store_insert_with_values(store, &row.iter, &sec.iter, -1,
+                                          COL_NAME, row.name.c_str(), COL_VALUE, row.value.c_str(),
+                                          COL_WEIGHT, PANGO_WEIGHT_NORMAL, COL_HEX, item.hex, -1);
+        sec.rows.push_back(std::move(row));
+    }
+    if (sec.expanded && !sec.rows.empty()) expandSection(sec);
+}
+
+void LogPanel::syncSection(int s, bool present, const char *title, const std::string &value,
+                           const std::vector<Item> &new_items) {
+    Section &sec = sections[s];
+    if (!present) {
+        if (sec.present) {
+            if (!sec.rows.empty()) sec.expanded = sectionExpanded(sec);
+            gtk_tree_store_remove(store, &sec.iter);
+            sec.rows.clear();
+            sec.present = false;
+        }
+        return;
+    }
+
+    if (!sec.present) {
+        // 插在前一个存在的组之后，保持分组顺序
+        GtkTreeIter *prev = NULL;
+        for (int p = s - 1; p >= 0 && !prev; --p) {
+            if (sections[p].present) prev = &sections[p].iter;
+        }
+        gtk_tree_store_insert_after(store, &sec.iter, NULL, prev);
+        gtk_tree_store_set(store, &sec.iter, COL_NAME, title, COL_VALUE, value.c_str(),
+                           COL_WEIGHT, PANGO_WEIGHT_BOLD, COL_HEX, FALSE, -1);
+        sec.present = true;
+        sec.value = value;
+    } else if (sec.value != value) {
+        sec.value = value;
+        gtk_tree_store_set(store, &sec.iter, COL_VALUE, value.c_str(), -1);
+    }
+
+    bool same_names = sec.rows.size() == new_items.size();
+    for (size_t i = 0; same_names && i < new_items.size(); ++i) {
+        same_names = sec.rows[i].name == *new_items[i].name;
+    }
+    if (!same_names) {
+        rebuildRows(sec, new_items);
+        return;
+    }
+
+    // 只改值变了的行；上一帧加粗、这一帧没变的行恢复常规字重
+    for (size_t i = 0; i < new_items.size(); ++i) {
+        Row &row = sec.rows[i];
+        if (row.value != *new_items[i].value) {
+            row.value = *new_items[i].value;
+            row.bold = true;
+            gtk_tree_store_set(store, &row.iter, COL_VALUE, row.value.c_str(),
+                               COL_WEIGHT, PANGO_WEIGHT_BOLD, -1);
+        } else if (row.bold) {
+            row.bold = false;
+            gtk_tree_store_set(store, &row.iter, COL_WEIGHT, PANGO_WEIGHT_NORMAL, -1);
+        }
+    }
+}
+
+void LogPanel::update(int frame_index, const std::vector<DynamicLogVariable> *dynamic_logs, const CSVReader &csv) {
+    const int record_count = csv.getRecordCount();
+    const bool has_csv = record_count > 0;
+    const bool has_dynamic = dynamic_logs && !dynamic_logs->empty();
+    const bool empty = !has_csv && !has_dynamic;
+
+    items.clear();
+    frame_text = std::to_string(frame_index);
+    if (has_csv) frame_text += " / " + std::to_string(record_count);
+    syncSection(SECTION_FRAME, !empty, "当前帧", frame_text, items);
+
+    static const std::string hint = "点击\"加载日志CSV\"加载文件，或在代码中使用 log_add_*() 函数添加日志";
+    syncSection(SECTION_HINT, empty, "未加载日志文件", hint, items);
+
+    // 动态日志（代码添加，优先显示）
+    if (has_dynamic) {
+        for (const DynamicLogVariable &var : *dynamic_logs) {
+            items.push_back(Item{&var.name, &var.value_str, false});
+        }
+        count_text = std::to_string(dynamic_logs->size()) + " 项";
+    }
+    syncSection(SECTION_DYNAMIC, has_dynamic, "动态日志", count_text, items);
+
+    // CSV 日志：帧号从 1 开始，记录从 0 开始；组标题后显示时间戳
+    items.clear();
+    const LogRecord *record = NULL;
+    if (has_csv) {
+        const int log_index = frame_index > 0 ? frame_index - 1 : 0;
+        record = csv.findLog(log_index);
+    }
+    if (record) {
+        for (const std::string &name : csv.getVariableNames()) {
+            auto it = record->variables.find(name);
+            if (it != record->variables.end()) items.push_back(Item{&name, &it->second, false});
+        }
+        if (!record->log_utf8.empty()) items.push_back(Item{&NAME_UTF8, &record->log_utf8, false});
+        if (!record->log_hex.empty()) items.push_back(Item{&NAME_HEX, &record->log_hex, true});
+    }
+    static const std::string out_of_range = "当前帧超出CSV日志范围";
+    syncSection(SECTION_CSV, has_csv, "CSV 日志", record ? record->timestamp : out_of_range, items);
+}
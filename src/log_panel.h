@@ -0,0 +1,77 @@
+#ifndef LOG_PANEL_H
+#define LOG_PANEL_H
+
+#include <gtk/gtk.h>
+#include <string>
+#include <vector>
+#include "csv_reader.h"
+#include "dynamic_log.h"
+
+// 实时日志面板（TreeView + TreeStore）
+// - 分组：当前帧 / 提示 / 动态日志 / CSV 日志，各组下每个变量一行
+// - 换帧时逐行比较上一帧的值，只改值变了的行（变了的行加粗，下一帧恢复）；
+//   变量集合变化（名字或顺序不同）时才重建该组
+// - Hex 数据在模型里存原始串，按 32 字符分行只在该行被绘制时做
+// - 只有可见行会被 TreeView 布局和绘制，几百个变量（如 l_border/r_border 数组）也不卡
+class LogPanel {
+public:
+    LogPanel();
+    ~LogPanel();
+
+    LogPanel(const LogPanel &) = delete;
+    LogPanel &operator=(const LogPanel &) = delete;
+
+    // 面板控件（滚动窗口，内含 TreeView）
+    GtkWidget* getWidget() { return scroll; }
+
+    // 显示第 frame_index 帧（从 1 开始）的日志；dynamic_logs 为 NULL 表示该帧没有动态日志
+    void update(int frame_index, const std::vector<DynamicLogVariable>* dynamic_logs, const CSVReader& csv);
+
+private:
+    enum { SECTION_FRAME, SECTION_HINT, SECTION_DYNAMIC, SECTION_CSV, SECTION_COUNT };
+
+    // 一行：名字 + 值
+    struct Item {
+        const std::string* name;
+        const std::string* value;
+        bool hex;   // 值为原始 hex 串，显示时分行
+    };
+
+    struct Row {
+        std::string name;
+        std::string value;
+        GtkTreeIter iter;
+        bool bold;
+    };
+
+    struct Section {
+        bool present = false;
+        bool expanded = true;   // 子行被整组重建时沿用的展开状态
+        GtkTreeIter iter;
+        std::string value;
+        std::vector<Row> rows;
+    };
+
+    void syncSection(int s, bool present, const char* title, const std::string& value, const std::vector<Item>& items);
+    void rebuildRows(Section& sec, const std::vector<Item>& items);
+    bool sectionExpanded(Section& sec);
+    void expandSection(Section& sec);
+
+    static void renderValue(GtkTreeViewColumn* column, GtkCellRenderer* cell, GtkTreeModel* model,
+                            GtkTreeIter* iter, gpointer data);
+    static void onSizeAllocate(GtkWidget* widget, GdkRectangle* allocation, gpointer data);
+
+    GtkWidget* scroll;
+    GtkWidget* tree_view;
+    GtkTreeStore* store;
+    GtkTreeViewColumn* name_column;
+    GtkCellRenderer* value_renderer;
+    int wrap_width;
+
+    Section sections[SECTION_COUNT];
+    std::vector<Item> items;        // 复用的临时行列表
+    std::string frame_text;
+    std::string count_text;
+};
+
+#endif // LOG_PANEL_H
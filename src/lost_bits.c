@@ -0,0 +1,8 @@
+#include "lost_bits.h"
+
+void lost_bits_unpack(const lost_bits *b, uint8_t *out, int rows)
+{
+    for (int y = 0; y < rows; y++) {
+        out[y] = lost_bits_test(b, y);
+    }
+}
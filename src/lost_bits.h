@@ -0,0 +1,184 @@
+#ifndef LOST_BITS_H
+#define LOST_BITS_H
+
+/*
+  丢线标志位图（120 行 → 两个 uint64 字）
+
+  设计说明：
+  - 第 y 位表示第 y 行（自底向上，与 l_border 下标一致）是否丢线，1 = 丢线。
+  - 检测函数里原先 "!right_lost[y-5] && ... && !right_lost[y+5]" 这类逐行布尔链，
+    改为先用移位/按位或一次性求出“窗口内全未丢线”的候选行位图，再逐个取候选行。
+  - 丢线数直接由 popcount 得到，不再在提取边线时逐点加减计数。
+  - 位图外（y < 0 或 y >= image_h）的行视为未丢线。
+*/
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 199901L) || defined(__cplusplus)
+  #define LOST_BITS_INLINE static inline
+#else
+  #define LOST_BITS_INLINE static
+#endif
+
+#define LOST_BITS_ROWS 120
+
+typedef struct {
+    uint64_t w[2];   /* w[0]：第 0~63 行，w[1]：第 64~119 行 */
+} lost_bits;
+
+/* 第 0~119 行全部置位时高字的掩码 */
+#define LOST_BITS_HI_MASK ((((uint64_t)1) << (LOST_BITS_ROWS - 64)) - 1)
+
+LOST_BITS_INLINE void lost_bits_fill(lost_bits *b)
+{
+    b->w[0] = ~(uint64_t)0;
+    b->w[1] = LOST_BITS_HI_MASK;
+}
+
+LOST_BITS_INLINE void lost_bits_set(lost_bits *b, int y)
+{
+    b->w[y >> 6] |= (uint64_t)1 << (y & 63);
+}
+
+LOST_BITS_INLINE void lost_bits_clear(lost_bits *b, int y)
+{
+    b->w[y >> 6] &= ~((uint64_t)1 << (y & 63));
+}
+
+/* 单行查询，越界行视为未丢线 */
+LOST_BITS_INLINE uint8_t lost_bits_test(const lost_bits *b, int y)
+{
+    if (y < 0 || y >= LOST_BITS_ROWS) return 0;
+    return (uint8_t)((b->w[y >> 6] >> (y & 63)) & 1u);
+}
+
+LOST_BITS_INLINE int lost_bits_popcount64(uint64_t v)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(v);
+#else
+    v = v - ((v >> 1) & 0x5555555555555555ull);
+    v = (v & 0x3333333333333333ull) + ((v >> 2) & 0x3333333333333333ull);
+    v = (v + (v >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+    return (int)((v * 0x0101010101010101ull) >> 56);
+#endif
+}
+
+/* 丢线行数 */
+LOST_BITS_INLINE uint8_t lost_bits_count(const lost_bits *b)
+{
+    return (uint8_t)(lost_bits_popcount64(b->w[0]) + lost_bits_popcount64(b->w[1]));
+}
+
+/* 取出 [lo, hi] 行（hi - lo < 64）对齐到第 0 位的窗口 */
+LOST_BITS_INLINE uint64_t lost_bits_window(const lost_bits *b, int lo, int hi)
+{
+    uint64_t v;
+    if (lo < 0) lo = 0;
+    if (hi >= LOST_BITS_ROWS) hi = LOST_BITS_ROWS - 1;
+    if (hi < lo) return 0;
+    if (lo >= 64) {
+        v = b->w[1] >> (lo - 64);
+    } else if (lo == 0) {
+        v = b->w[0];
+    } else {
+        v = (b->w[0] >> lo) | (b->w[1] << (64 - lo));
+    }
+    if (hi - lo < 63) v &= (((uint64_t)1) << (hi - lo + 1)) - 1;
+    return v;
+}
+
+/* [lo, hi] 行全部未丢线 */
+LOST_BITS_INLINE uint8_t lost_bits_window_clear(const lost_bits *b, int lo, int hi)
+{
+    return lost_bits_window(b, lo, hi) == 0;
+}
+
+/* [lo, hi] 行中存在丢线 */
+LOST_BITS_INLINE uint8_t lost_bits_window_any(const lost_bits *b, int lo, int hi)
+{
+    return lost_bits_window(b, lo, hi) != 0;
+}
+
+/* 整体移位：结果第 y 位 = 原第 y + k 位（k 可正可负，移出范围的补 0） */
+LOST_BITS_INLINE lost_bits lost_bits_shift(lost_bits b, int k)
+{
+    lost_bits r;
+    if (k >= 64) {
+        r.w[0] = b.w[1] >> (k - 64);
+        r.w[1] = 0;
+    } else if (k > 0) {
+        r.w[0] = (b.w[0] >> k) | (b.w[1] << (64 - k));
+        r.w[1] = b.w[1] >> k;
+    } else if (k <= -64) {
+        r.w[0] = 0;
+        r.w[1] = b.w[0] << (-k - 64);
+    } else if (k < 0) {
+        r.w[0] = b.w[0] << -k;
+        r.w[1] = (b.w[1] << -k) | (b.w[0] >> (64 + k));
+    } else {
+        r = b;
+    }
+    r.w[1] &= LOST_BITS_HI_MASK;
+    return r;
+}
+
+/*
+  候选行位图：第 y 位置 1 当且仅当 [y + lo, y + hi] 行全部未丢线
+  （即把丢线位按窗口“膨胀”后取反）
+*/
+LOST_BITS_INLINE lost_bits lost_bits_clear_rows(const lost_bits *b, int lo, int hi)
+{
+    lost_bits acc = {{0, 0}};
+    for (int k = lo; k <= hi; k++) {
+        lost_bits s = lost_bits_shift(*b, k);
+        acc.w[0] |= s.w[0];
+        acc.w[1] |= s.w[1];
+    }
+    acc.w[0] = ~acc.w[0];
+    acc.w[1] = ~acc.w[1] & LOST_BITS_HI_MASK;
+    return acc;
+}
+
+LOST_BITS_INLINE lost_bits lost_bits_and(lost_bits a, lost_bits b)
+{
+    a.w[0] &= b.w[0];
+    a.w[1] &= b.w[1];
+    return a;
+}
+
+LOST_BITS_INLINE int lost_bits_ctz64(uint64_t v)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(v);
+#else
+    int n = 0;
+    while (!(v & 1u)) { v >>= 1; n++; }
+    return n;
+#endif
+}
+
+/* 从第 from 行（含）起向上找第一个置位行，找不到返回 -1 */
+LOST_BITS_INLINE int lost_bits_next(const lost_bits *b, int from)
+{
+    if (from < 0) from = 0;
+    for (int i = from >> 6; i < 2; i++) {
+        uint64_t v = b->w[i];
+        if (i == (from >> 6)) v &= ~(uint64_t)0 << (from & 63);
+        if (v) return (i << 6) + lost_bits_ctz64(v);
+    }
+    return -1;
+}
+
+/* 展开为逐行 uint8 数组（0/1），供日志等按字节读取的场景使用 */
+void lost_bits_unpack(const lost_bits *b, uint8_t *out, int rows);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LOST_BITS_H */
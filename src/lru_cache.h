@@ -0,0 +1,93 @@
+#ifndef LRU_CACHE_H
+#define LRU_CACHE_H
+
+#include <cstddef>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+// 按字节计费的 LRU 缓存（单线程使用）
+// - put：插入或替换，按调用者给的 cost 计入占用；超出容量时从最久未用的一端淘汰
+//   单个条目的 cost 超过容量时不缓存
+// - find：命中时把条目移到最近使用端并返回值指针，指针在下一次 put / set_capacity / clear 前有效
+// - set_capacity：调小后立即淘汰到容量以内；容量为 0 即不缓存
+template <typename K, typename V>
+class LruCache {
+public:
+    explicit LruCache(std::size_t capacity_bytes) : capacity_(capacity_bytes) {}
+
+    LruCache(const LruCache &) = delete;
+    LruCache &operator=(const LruCache &) = delete;
+
+    V *find(const K &key) {
+        auto it = index_.find(key);
+        if (it == index_.end()) {
+            ++misses_;
+            return nullptr;
+        }
+        ++hits_;
+        items_.splice(items_.begin(), items_, it->second);
+        return &it->second->value;
+    }
+
+    bool contains(const K &key) const { return index_.count(key) != 0; }
+
+    void put(const K &key, V value, std::size_t cost) {
+        erase(key);
+        if (cost > capacity_) return;
+        items_.push_front(Entry{key, std::move(value), cost});
+        index_[key] = items_.begin();
+        bytes_ += cost;
+        evict();
+    }
+
+    void erase(const K &key) {
+        auto it = index_.find(key);
+        if (it == index_.end()) return;
+        bytes_ -= it->second->cost;
+        items_.erase(it->second);
+        index_.erase(it);
+    }
+
+    void clear() {
+        items_.clear();
+        index_.clear();
+        bytes_ = 0;
+    }
+
+    void set_capacity(std::size_t capacity_bytes) {
+        capacity_ = capacity_bytes;
+        evict();
+    }
+
+    std::size_t capacity() const { return capacity_; }
+    std::size_t bytes() const { return bytes_; }
+    std::size_t size() const { return items_.size(); }
+    std::size_t hits() const { return hits_; }
+    std::size_t misses() const { return misses_; }
+
+private:
+    struct Entry {
+        K key;
+        V value;
+        std::size_t cost;
+    };
+
+    void evict() {
+        while (bytes_ > capacity_ && !items_.empty()) {
+            const Entry &victim = items_.back();
+            bytes_ -= victim.cost;
+            index_.erase(victim.key);
+            items_.pop_back();
+        }
+    }
+
+    std::list<Entry> items_;  // 头部最近使用
+    std::unordered_map<K, typename std::list<Entry>::iterator> index_;
+    std::size_t capacity_;
+    std::size_t bytes_ = 0;
+    std::size_t hits_ = 0;
+    std::size_t misses_ = 0;
+};
+
+#endif // LRU_CACHE_H
@@ -0,0 +1,120 @@
+#ifndef LUMA_CAPTURE_H
+#define LUMA_CAPTURE_H
+
+// 仅取亮度（Y 平面）的视频解码封装（仅在有 OpenCV 的目标中包含）
+// - 打开时关闭 CAP_PROP_CONVERT_RGB，让后端直接交出解码器的原始输出，省掉 YUV→BGR 转换
+//   以及 3 通道帧的读写带宽；得到的单通道帧以 GRAY8 交给 frame_binarize，不做任何颜色转换
+// - 首帧探测原始输出的布局：
+//     单通道 w×h            → 已是亮度平面，原样返回
+//     单通道 w×(h*3/2)      → I420/YV12/NV12，前 h 行即 Y 平面，返回行区间视图（零拷贝）
+//     其他（BGR、打包 YUV、压缩包等）→ 以 CONVERT_RGB 重新打开，退回普通 BGR 解码
+// - 探测读出的首帧缓存起来作为第一次 read() 的结果；set() 之后丢弃
+// - 接口与 cv::VideoCapture 同名，调用处只换类型即可
+
+#include <opencv2/opencv.hpp>
+#include <string>
+
+class LumaCapture {
+public:
+    LumaCapture() = default;
+    LumaCapture(const LumaCapture &) = delete;
+    LumaCapture &operator=(const LumaCapture &) = delete;
+
+    // luma_only=false 时与普通 cv::VideoCapture 完全一致
+    bool open(const std::string &path, bool luma_only = true) {
+        release();
+        if (!cap_.open(path)) return false;
+        if (!luma_only) return true;
+
+        const int w = (int)cap_.get(cv::CAP_PROP_FRAME_WIDTH);
+        const int h = (int)cap_.get(cv::CAP_PROP_FRAME_HEIGHT);
+        if (w > 0 && h > 0 && cap_.set(cv::CAP_PROP_CONVERT_RGB, 0) && cap_.read(pending_)) {
+            layout_ = classify(pending_, w, h);
+            if (layout_ != Layout::Bgr) {
+                height_ = h;
+                has_pending_ = true;
+                return true;
+            }
+        }
+        // 后端不支持或布局无法识别：重新打开，按 BGR 解码
+        pending_.release();
+        layout_ = Layout::Bgr;
+        cap_.release();
+        return cap_.open(path);
+    }
+
+    bool isOpened() const { return cap_.isOpened(); }
+
+    void release() {
+        cap_.release();
+        pending_.release();
+        has_pending_ = false;
+        layout_ = Layout::Bgr;
+        height_ = 0;
+    }
+
+    // 是否处于仅亮度模式（read() 返回单通道帧）
+    bool luma() const { return layout_ != Layout::Bgr; }
+
+    bool read(cv::Mat &out) {
+        if (has_pending_) {
+            has_pending_ = false;
+            extract(pending_, out);
+            pending_.release();
+            return true;
+        }
+        cv::Mat raw;
+        if (!cap_.read(raw)) return false;
+        extract(raw, out);
+        return true;
+    }
+
+    // 只推进一帧、不取图（跳帧用，省掉取图与颜色转换）
+    bool grab() {
+        if (has_pending_) {
+            has_pending_ = false;
+            pending_.release();
+            return true;
+        }
+        return cap_.grab();
+    }
+
+    // 首帧已被探测读走时，后端的位置比调用者看到的多 1 帧
+    double get(int prop) const {
+        const double v = cap_.get(prop);
+        if (has_pending_ && (prop == cv::CAP_PROP_POS_FRAMES) && v > 0) return v - 1;
+        return v;
+    }
+
+    bool set(int prop, double value) {
+        has_pending_ = false;
+        pending_.release();
+        return cap_.set(prop, value);
+    }
+
+private:
+    enum class Layout { Bgr, Gray, Planar420 };
+
+    static Layout classify(const cv::Mat &raw, int w, int h) {
+        if (raw.type() != CV_8UC1 || raw.cols != w) return Layout::Bgr;
+        if (raw.rows == h) return Layout::Gray;
+        if (raw.rows == h * 3 / 2) return Layout::Planar420;
+        return Layout::Bgr;
+    }
+
+    void extract(const cv::Mat &raw, cv::Mat &out) const {
+        if (layout_ == Layout::Planar420 && raw.rows > height_) {
+            out = raw.rowRange(0, height_);
+        } else {
+            out = raw;
+        }
+    }
+
+    cv::VideoCapture cap_;
+    cv::Mat pending_;
+    bool has_pending_ = false;
+    Layout layout_ = Layout::Bgr;
+    int height_ = 0;
+};
+
+#endif // LUMA_CAPTURE_H
@@ -4,11 +4,15 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdint.h>
+#include <limits.h>
 #include "processor.h"
 #include "global_image_buffer.h"
 #include "csv_reader.h"
 #include "oscilloscope.h"
 #include "dynamic_log.h"
+#include "log_panel.h"
+#include "indexed_render.h"
+#include "pixbuf_pool.h"
 
 #ifdef HAVE_OPENCV
 // 兼容 MSYS2 mingw64 (msvcrt) 缺少 quick_exit/timespec_get 的环境：
@@ -21,6 +25,20 @@ extern "C" {
 #include <opencv2/opencv.hpp>
 #include <string>
 #include <vector>
+#include "frame_binarize_cv.h"
+#include "luma_capture.h"
+#include "frame_archive.h"
+#include "bounded_queue.h"
+#include "lru_cache.h"
+#include "thumb_cache.h"
+#include "image.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include "ab_compare.h"
 #endif
 
 // 复用原有全局
@@ -36,9 +54,13 @@ static int image_height = IMAGE_H;
 static const int TARGET_WIDTH = IMAGE_W;
 static const int TARGET_HEIGHT = IMAGE_H;
 
+// 三个图像区的显示 pixbuf 从池里取，窗口尺寸不变时逐帧复用（预取线程也从这里取）
+static PixbufPool g_view_pixbufs(8);
+
 #ifdef HAVE_OPENCV
 // 视频相关状态
-static cv::VideoCapture g_cap;
+static LumaCapture g_cap;
+static gboolean g_luma_decode = FALSE;   // 仅解码亮度平面（省掉 YUV→BGR 转换）
 static int g_frame_index = 0;
 static std::string g_video_path;
 static guint g_playback_timer = 0;      // 播放定时器ID
@@ -47,15 +69,65 @@ static double g_playback_speed = 1.0;   // 播放倍速
 static GtkWidget *g_play_button = NULL; // 播放/暂停按钮
 static GtkWidget *g_progress_scale = NULL; // 进度条
 static gboolean g_updating_progress = FALSE; // 是否正在更新进度条（避免递归）
+static frame_archive g_archive;         // 已打开的帧归档（map.base 非空即归档模式，代替视频作为帧源）
+static int g_archive_pos = -1;          // 归档中当前帧（从 0 开始）
+static int g_cap_next = 0;              // g_cap 下一次 read 得到的帧位置（从 0 开始）
+
+// 一帧的分阶段耗时（µs）：各流水线阶段（PIPELINE_PROFILE 打点）+ 图像区渲染
+struct FrameTiming {
+    uint32_t stage_us[PIPELINE_STAGE_COUNT] = {};
+    uint32_t render_us = 0;
+};
+static FrameTiming g_frame_timing;      // 当前显示帧的耗时
+static uint32_t g_source_render_us = 0; // 本帧源帧视图的渲染耗时，run_pipeline_on_original 计入 render 后清零
+
+// 视频帧缓存：解码帧及其处理结果，按帧位置（从 0 开始）存放，占用上限可在工具栏调整
+static const int FRAME_CACHE_DEFAULT_MB = 256;
+struct CachedFrame {
+    cv::Mat frame;                        // 解码帧（独占内存，不引用解码器缓冲）
+    bool processed = false;               // 以下结果是否有效（回填解码的帧尚未处理）
+    uint8_t original[IMAGE_H][IMAGE_W];
+    uint8_t imo[IMAGE_H][IMAGE_W];
+    struct watch_o watch;
+    std::vector<DynamicLogVariable> logs;
+    FrameTiming timing;                   // 处理时记下的耗时，命中时只显示不计入统计
+};
+static LruCache<int, CachedFrame> g_frame_cache((size_t)FRAME_CACHE_DEFAULT_MB << 20);
+
+// 播放预取需要每条线程各有一份流水线全局状态（PIPELINE_THREAD_LOCAL）；否则退回在定时器里逐帧处理
+#if defined(PIPELINE_THREAD_LOCAL)
+#define PLAYBACK_PREFETCH 1
+#else
+#define PLAYBACK_PREFETCH 0
+#endif
+
+// 播放调度：按墙钟算每帧的显示时刻（详见 playback_timer_callback 前的说明）
+struct PlaybackClock {
+    std::chrono::steady_clock::time_point t0;     // 开播时刻；不允许丢帧时随落后量顺延
+    std::chrono::microseconds interval{40000};    // 帧间隔（已计入倍速）
+    long long seq = 0;                            // 下一帧的序号（从开播起数，含丢掉的帧）
+    int dropped = 0;
+    long long max_late_us = 0;                    // 最大延迟：帧实际显示时刻减其显示时刻
+    std::chrono::steady_clock::time_point stat_t0;   // 实际帧率统计窗口起点
+    int stat_frames = 0;
+    double fps = 0.0;
+};
+static PlaybackClock g_clock;
+static gboolean g_allow_drop = TRUE;              // 来不及时跳过帧（只前进不处理）
+static GtkWidget *g_playback_status = NULL;       // 进度条旁：实际帧率 / 丢帧 / 最大延迟
 
 // 日志显示相关
 static CSVReader g_csv_reader;
-static GtkWidget *g_log_text_view = NULL;  // 日志显示文本框
-static GtkTextBuffer *g_log_buffer = NULL; // 日志文本缓冲区
+static LogPanel *g_log_panel = NULL;       // 日志面板（逐行增量更新）
 static std::string g_csv_file_path;        // 保存CSV文件路径
 
 // 示波器
 static OscilloscopeWindow *g_oscilloscope = NULL;
+
+#if AB_COMPARE
+// A/B 对比窗口（首次打开时创建，进程退出前回收）；预取线程也要看它是否开着
+static std::atomic<AbCompareWindow*> g_ab{nullptr};
+#endif
 #endif
 
 // 前置声明
@@ -65,6 +137,9 @@ static void free_binary_image_data();
 static void allocate_imo_array();
 static void refresh_all_views();
 static void on_size_allocate(GtkWidget *widget, GdkRectangle *allocation, gpointer user_data);
+static bool view_visible(GtkWidget *widget);
+static void on_view_map(GtkWidget *widget, gpointer user_data);
+static gboolean on_window_state(GtkWidget *widget, GdkEventWindowState *event, gpointer user_data);
 static GdkPixbuf* scale_pixbuf_to_target(GdkPixbuf *pixbuf);
 static GdkPixbuf* scale_pixbuf_to_fit(GdkPixbuf *pixbuf, int max_width, int max_height);
 
@@ -77,8 +152,7 @@ static gboolean load_png_image(const gchar *filename);
 static gboolean load_jpeg_image(const gchar *filename);
 static gboolean is_png_file(const gchar *filename);
 static gboolean is_jpeg_file(const gchar *filename);
-static GdkPixbuf* render_bw_array_pixbuf(uint8_t **arr, int w, int h, int pixel_size);
-static GdkPixbuf* render_imo_array_pixbuf(uint8_t **arr, int w, int h, int pixel_size);
+static GdkPixbuf* render_bw_array_pixbuf(uint8_t arr[IMAGE_H][IMAGE_W], int w, int h, int pixel_size);
 
 #ifdef HAVE_OPENCV
 // 视频导入相关回调
@@ -86,9 +160,14 @@ static void open_video_clicked(GtkWidget *widget, gpointer data);
 static void next_frame_clicked(GtkWidget *widget, gpointer data);
 static void prev_frame_clicked(GtkWidget *widget, gpointer data);
 static void show_cv_frame(const cv::Mat &frame);
+static void show_pending_source();
+static cv::Mat own_frame(const cv::Mat &frame);
 static void open_tiled_selector_clicked(GtkWidget *widget, gpointer data);
 static void play_pause_clicked(GtkWidget *widget, gpointer data);
 static void speed_changed(GtkWidget *widget, gpointer data);
+static void luma_decode_toggled(GtkToggleButton *button, gpointer data);
+static void allow_drop_toggled(GtkToggleButton *button, gpointer data);
+static void frame_cache_size_changed(GtkSpinButton *spin, gpointer data);
 static gboolean playback_timer_callback(gpointer user_data);
 static void stop_playback();
 static void start_playback();
@@ -97,6 +176,18 @@ static void update_progress_bar();
 static void load_log_csv_clicked(GtkWidget *widget, gpointer data);
 static void update_log_display(int frame_index);
 static void open_oscilloscope_clicked(GtkWidget *widget, gpointer data);
+#if AB_COMPARE
+static void open_ab_compare_clicked(GtkWidget *widget, gpointer data);
+#endif
+static void open_archive_clicked(GtkWidget *widget, gpointer data);
+static bool show_archive_frame(int index);
+static void run_pipeline_on_original();
+static void update_frame_panels();
+static GtkWidget *timing_panel_new();
+static void timing_panel_show(const FrameTiming &t, bool record);
+#if PLAYBACK_PREFETCH
+static void prefetch_stop();
+#endif
 #endif
 
 int main(int argc, char **argv) {
@@ -105,6 +196,12 @@ int main(int argc, char **argv) {
     app = gtk_application_new("com.example.binaryimage", G_APPLICATION_DEFAULT_FLAGS);
     g_signal_connect(app, "activate", G_CALLBACK(activate), NULL);
     status = g_application_run(G_APPLICATION(app), argc, argv);
+#if defined(HAVE_OPENCV) && PLAYBACK_PREFETCH
+    prefetch_stop(); // 播放中关窗：先收回预取线程
+#endif
+#if AB_COMPARE
+    delete g_ab.exchange(nullptr);
+#endif
     g_object_unref(app);
 
     free_binary_image_data();
@@ -135,6 +232,10 @@ static void activate(GtkApplication *app, gpointer user_data) {
     gtk_box_pack_start(GTK_BOX(hbox), open_video_btn, FALSE, FALSE, 0);
     g_signal_connect(open_video_btn, "clicked", G_CALLBACK(open_video_clicked), NULL);
 
+    GtkWidget *open_archive_btn = gtk_button_new_with_label("打开帧归档");
+    gtk_box_pack_start(GTK_BOX(hbox), open_archive_btn, FALSE, FALSE, 0);
+    g_signal_connect(open_archive_btn, "clicked", G_CALLBACK(open_archive_clicked), NULL);
+
     GtkWidget *load_log_btn = gtk_button_new_with_label("加载日志CSV");
     gtk_box_pack_start(GTK_BOX(hbox), load_log_btn, FALSE, FALSE, 0);
     g_signal_connect(load_log_btn, "clicked", G_CALLBACK(load_log_csv_clicked), NULL);
@@ -143,6 +244,12 @@ static void activate(GtkApplication *app, gpointer user_data) {
     gtk_box_pack_start(GTK_BOX(hbox), oscilloscope_btn, FALSE, FALSE, 0);
     g_signal_connect(oscilloscope_btn, "clicked", G_CALLBACK(open_oscilloscope_clicked), NULL);
 
+#if AB_COMPARE
+    GtkWidget *ab_btn = gtk_button_new_with_label("A/B 对比");
+    gtk_box_pack_start(GTK_BOX(hbox), ab_btn, FALSE, FALSE, 0);
+    g_signal_connect(ab_btn, "clicked", G_CALLBACK(open_ab_compare_clicked), NULL);
+#endif
+
     GtkWidget *prev_btn = gtk_button_new_with_label("上一帧");
     gtk_box_pack_start(GTK_BOX(hbox), prev_btn, FALSE, FALSE, 0);
     g_signal_connect(prev_btn, "clicked", G_CALLBACK(prev_frame_clicked), NULL);
@@ -172,6 +279,23 @@ static void activate(GtkApplication *app, gpointer user_data) {
     GtkWidget *tiled_btn = gtk_button_new_with_label("平铺选帧");
     gtk_box_pack_start(GTK_BOX(hbox), tiled_btn, FALSE, FALSE, 0);
     g_signal_connect(tiled_btn, "clicked", G_CALLBACK(open_tiled_selector_clicked), NULL);
+
+    GtkWidget *luma_check = gtk_check_button_new_with_label("仅亮度解码");
+    gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(luma_check), g_luma_decode);
+    gtk_box_pack_start(GTK_BOX(hbox), luma_check, FALSE, FALSE, 0);
+    g_signal_connect(luma_check, "toggled", G_CALLBACK(luma_decode_toggled), NULL);
+
+    GtkWidget *drop_check = gtk_check_button_new_with_label("允许丢帧");
+    gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(drop_check), g_allow_drop);
+    gtk_box_pack_start(GTK_BOX(hbox), drop_check, FALSE, FALSE, 0);
+    g_signal_connect(drop_check, "toggled", G_CALLBACK(allow_drop_toggled), NULL);
+
+    GtkWidget *cache_label = gtk_label_new("帧缓存(MB):");
+    gtk_box_pack_start(GTK_BOX(hbox), cache_label, FALSE, FALSE, 0);
+    GtkWidget *cache_spin = gtk_spin_button_new_with_range(0, 4096, 64);
+    gtk_spin_button_set_value(GTK_SPIN_BUTTON(cache_spin), FRAME_CACHE_DEFAULT_MB);
+    gtk_box_pack_start(GTK_BOX(hbox), cache_spin, FALSE, FALSE, 0);
+    g_signal_connect(cache_spin, "value-changed", G_CALLBACK(frame_cache_size_changed), NULL);
 #endif
 
 #ifdef HAVE_OPENCV
@@ -187,6 +311,8 @@ static void activate(GtkApplication *app, gpointer user_data) {
     gtk_scale_set_value_pos(GTK_SCALE(g_progress_scale), GTK_POS_RIGHT);
     gtk_box_pack_start(GTK_BOX(progress_hbox), g_progress_scale, TRUE, TRUE, 0);
     g_signal_connect(g_progress_scale, "value-changed", G_CALLBACK(progress_scale_changed), NULL);
+    g_playback_status = gtk_label_new("");
+    gtk_box_pack_start(GTK_BOX(progress_hbox), g_playback_status, FALSE, FALSE, 0);
 #endif
 
     // 使用水平分隔面板代替固定布局,支持拖动调整
@@ -248,39 +374,24 @@ static void activate(GtkApplication *app, gpointer user_data) {
     GtkWidget *log_frame = gtk_frame_new("实时日志");
     gtk_frame_set_shadow_type(GTK_FRAME(log_frame), GTK_SHADOW_ETCHED_IN);
     
-    // 创建滚动窗口
-    GtkWidget *log_scroll = gtk_scrolled_window_new(NULL, NULL);
-    gtk_scrolled_window_set_policy(GTK_SCROLLED_WINDOW(log_scroll), 
-                                    GTK_POLICY_AUTOMATIC, GTK_POLICY_AUTOMATIC);
-    // 移除固定高度限制，改为最小高度
-    gtk_widget_set_size_request(log_scroll, -1, 100); // 最小高度100像素
-    
-    // 创建文本视图
-    g_log_text_view = gtk_text_view_new();
-    gtk_text_view_set_editable(GTK_TEXT_VIEW(g_log_text_view), FALSE);
-    gtk_text_view_set_wrap_mode(GTK_TEXT_VIEW(g_log_text_view), GTK_WRAP_WORD_CHAR);
-    
-    // 设置等宽字体（使用CSS Provider代替弃用的override_font）
-    GtkCssProvider *provider = gtk_css_provider_new();
-    gtk_css_provider_load_from_data(provider, 
-        "textview { font-family: Monospace; font-size: 10pt; }", -1, NULL);
-    gtk_style_context_add_provider(
-        gtk_widget_get_style_context(g_log_text_view),
-        GTK_STYLE_PROVIDER(provider),
-        GTK_STYLE_PROVIDER_PRIORITY_APPLICATION);
-    g_object_unref(provider);
-    
-    g_log_buffer = gtk_text_view_get_buffer(GTK_TEXT_VIEW(g_log_text_view));
-    
-    gtk_container_add(GTK_CONTAINER(log_scroll), g_log_text_view);
-    gtk_container_add(GTK_CONTAINER(log_frame), log_scroll);
-    // 使用 GtkPaned 添加日志区域，使其可拖动调整大小
-    gtk_paned_pack2(GTK_PANED(right_vpaned), log_frame, FALSE, TRUE);
+    g_log_panel = new LogPanel();
+    gtk_widget_set_size_request(g_log_panel->getWidget(), -1, 100); // 最小高度100像素
+    gtk_container_add(GTK_CONTAINER(log_frame), g_log_panel->getWidget());
+    // 日志下方是分阶段耗时面板；两者一起放进 GtkPaned 下半部分，可拖动调整大小
+    GtkWidget *log_vbox = gtk_box_new(GTK_ORIENTATION_VERTICAL, 5);
+    gtk_box_pack_start(GTK_BOX(log_vbox), log_frame, TRUE, TRUE, 0);
+    gtk_box_pack_start(GTK_BOX(log_vbox), timing_panel_new(), FALSE, FALSE, 0);
+    gtk_paned_pack2(GTK_PANED(right_vpaned), log_vbox, FALSE, TRUE);
 #endif
 
     g_signal_connect(current_frame, "size-allocate", G_CALLBACK(on_size_allocate), NULL);
     g_signal_connect(orig_frame, "size-allocate", G_CALLBACK(on_size_allocate), NULL);
     g_signal_connect(imo_frame, "size-allocate", G_CALLBACK(on_size_allocate), NULL);
+    // 图像区不可见时跳过渲染，重新出现（分隔条拉开、窗口还原）时补画
+    g_signal_connect(image_area, "map", G_CALLBACK(on_view_map), NULL);
+    g_signal_connect(original_array_area, "map", G_CALLBACK(on_view_map), NULL);
+    g_signal_connect(imo_image_view, "map", G_CALLBACK(on_view_map), NULL);
+    g_signal_connect(window, "window-state-event", G_CALLBACK(on_window_state), NULL);
 
     reset_image_views();
     gtk_widget_show_all(window);
@@ -472,90 +583,75 @@ static void allocate_imo_array() {
     }
 }
 
-static GdkPixbuf* render_bw_array_pixbuf(uint8_t arr[IMAGE_H][IMAGE_W], int w, int h, int pixel_size) {
-    if (!arr || w <= 0 || h <= 0) return NULL;
-    int W = w * pixel_size, H = h * pixel_size;
-    GdkPixbuf *pb = gdk_pixbuf_new(GDK_COLORSPACE_RGB, FALSE, 8, W, H);
+// 索引图经调色板查表直接渲染到 dst_w×dst_h（最近邻，整行复制）
+// pool 非空时从池里取 pixbuf（逐帧刷新的视图），否则新分配（缩略图等长期持有的）
+static GdkPixbuf* render_indexed_pixbuf(uint8_t arr[IMAGE_H][IMAGE_W], int w, int h,
+                                        const render_palette *pal, int dst_w, int dst_h,
+                                        PixbufPool *pool = NULL) {
+    if (!arr || w <= 0 || h <= 0 || dst_w <= 0 || dst_h <= 0) return NULL;
+    GdkPixbuf *pb = pool ? pool->acquire(dst_w, dst_h) : gdk_pixbuf_new(GDK_COLORSPACE_RGB, FALSE, 8, dst_w, dst_h);
     if (!pb) return NULL;
-    gdk_pixbuf_fill(pb, 0xffffffff);
-    int rowstride = gdk_pixbuf_get_rowstride(pb);
-    guchar *pixels = gdk_pixbuf_get_pixels(pb);
-    for (int y = 0; y < h; ++y) {
-        for (int x = 0; x < w; ++x) {
-            guint32 color = (arr[y][x] == 0) ? 0xff000000 : 0xffffffff;
-            for (int dy = 0; dy < pixel_size; ++dy)
-                for (int dx = 0; dx < pixel_size; ++dx) {
-                    guchar *p = pixels + (y * pixel_size + dy) * rowstride + (x * pixel_size + dx) * 3;
-                    p[0] = (color >> 16) & 0xff; p[1] = (color >> 8) & 0xff; p[2] = color & 0xff;
-                }
-        }
-    }
+    render_indexed_rgb24(&arr[0][0], w, h, IMAGE_W, pal,
+                         gdk_pixbuf_get_pixels(pb), dst_w, dst_h, gdk_pixbuf_get_rowstride(pb));
     return pb;
 }
 
-static GdkPixbuf* render_imo_array_pixbuf(uint8_t arr[IMAGE_H][IMAGE_W], int w, int h, int pixel_size) {
-    if (!arr || w <= 0 || h <= 0) return NULL;
-    int W = w * pixel_size, H = h * pixel_size;
-    GdkPixbuf *pb = gdk_pixbuf_new(GDK_COLORSPACE_RGB, FALSE, 8, W, H);
-    if (!pb) return NULL;
-    gdk_pixbuf_fill(pb, 0xffffffff);
-    int rowstride = gdk_pixbuf_get_rowstride(pb);
-    guchar *pixels = gdk_pixbuf_get_pixels(pb);
-    for (int y = 0; y < h; ++y) {
-        for (int x = 0; x < w; ++x) {
-            guint32 color;
-            switch (arr[y][x]) {
-                case 0: color = 0xff000000; break;
-                case 1: color = 0xffff0000; break;
-                case 2: color = 0xffffa500; break;
-                case 3: color = 0xffffff00; break;
-                case 4: color = 0xff00ff00; break;
-                case 5: color = 0xff00ffff; break;
-                case 255: default: color = 0xffffffff; break;
-            }
-            for (int dy = 0; dy < pixel_size; ++dy)
-                for (int dx = 0; dx < pixel_size; ++dx) {
-                    guchar *p = pixels + (y * pixel_size + dy) * rowstride + (x * pixel_size + dx) * 3;
-                    p[0] = (color >> 16) & 0xff; p[1] = (color >> 8) & 0xff; p[2] = color & 0xff;
-                }
-        }
-    }
-    return pb;
+// 调色板用函数内静态量初始化（线程安全），播放预取线程也会用到
+static const render_palette *bw_palette() {
+    static const render_palette pal = [] { render_palette p; render_palette_bw(&p); return p; }();
+    return &pal;
+}
+
+static const render_palette *imo_palette() {
+    static const render_palette pal = [] { render_palette p; render_palette_imo(&p); return p; }();
+    return &pal;
+}
+
+static GdkPixbuf* render_bw_array_pixbuf(uint8_t arr[IMAGE_H][IMAGE_W], int w, int h, int pixel_size) {
+    return render_indexed_pixbuf(arr, w, h, bw_palette(), w * pixel_size, h * pixel_size);
+}
+
+// 按 scale_pixbuf_to_fit 的规则算出显示尺寸后直接渲染，省掉中间放大图和二次缩放；pixbuf 取自视图池
+static GdkPixbuf* render_array_pixbuf_fit(uint8_t arr[IMAGE_H][IMAGE_W], const render_palette *pal,
+                                          int max_w, int max_h) {
+    if (max_w <= 0 || max_h <= 0) return NULL;
+    int dst_w, dst_h;
+    render_fit_size(IMAGE_W, IMAGE_H, max_w, max_h, &dst_w, &dst_h);
+    return render_indexed_pixbuf(arr, IMAGE_W, IMAGE_H, pal, dst_w, dst_h, &g_view_pixbufs);
+}
+
+// 图像区当前是否看得见：未映射（如被分隔条完全收起）或窗口最小化时不必渲染
+static bool view_visible(GtkWidget *widget) {
+    if (!widget || !gtk_widget_is_drawable(widget)) return false;
+    GdkWindow *toplevel = gtk_widget_get_window(window);
+    return !toplevel || !(gdk_window_get_state(toplevel) & GDK_WINDOW_STATE_ICONIFIED);
 }
 
 static void refresh_all_views() {
     // 获取各个图像区域的分配大小
     GtkAllocation alloc_orig, alloc_imo;
     
-    if (original_array_area) {
+    if (view_visible(original_array_area)) {
         gtk_widget_get_allocation(original_array_area, &alloc_orig);
         int max_w = alloc_orig.width > 50 ? alloc_orig.width - 20 : 400;
         int max_h = alloc_orig.height > 50 ? alloc_orig.height - 20 : 300;
         
-        GdkPixbuf *base = render_bw_array_pixbuf(original_bi_image, IMAGE_W, IMAGE_H, 2);
-        if (base) {
-            GdkPixbuf *scaled = scale_pixbuf_to_fit(base, max_w, max_h);
-            if (scaled) {
-                gtk_image_set_from_pixbuf(GTK_IMAGE(original_array_area), scaled);
-                g_object_unref(scaled);
-            }
-            g_object_unref(base);
+        GdkPixbuf *pb = render_array_pixbuf_fit(original_bi_image, bw_palette(), max_w, max_h);
+        if (pb) {
+            gtk_image_set_from_pixbuf(GTK_IMAGE(original_array_area), pb);
+            g_object_unref(pb);
         }
     }
     
-    if (imo_image_view) {
+    if (view_visible(imo_image_view)) {
         gtk_widget_get_allocation(imo_image_view, &alloc_imo);
         int max_w = alloc_imo.width > 50 ? alloc_imo.width - 20 : 400;
         int max_h = alloc_imo.height > 50 ? alloc_imo.height - 20 : 300;
         
-        GdkPixbuf *base = render_imo_array_pixbuf(imo, IMAGE_W, IMAGE_H, 2);
-        if (base) {
-            GdkPixbuf *scaled = scale_pixbuf_to_fit(base, max_w, max_h);
-            if (scaled) {
-                gtk_image_set_from_pixbuf(GTK_IMAGE(imo_image_view), scaled);
-                g_object_unref(scaled);
-            }
-            g_object_unref(base);
+        GdkPixbuf *pb = render_array_pixbuf_fit(imo, imo_palette(), max_w, max_h);
+        if (pb) {
+            gtk_image_set_from_pixbuf(GTK_IMAGE(imo_image_view), pb);
+            g_object_unref(pb);
         }
     }
 }
@@ -578,6 +674,24 @@ static void on_size_allocate(GtkWidget *widget, GdkRectangle *allocation, gpoint
     g_refresh_timeout_id = g_timeout_add(150, refresh_all_views_callback, NULL);
 }
 
+// 图像区重新映射：补画期间跳过的视图
+static void on_view_map(GtkWidget *widget, gpointer user_data) {
+    (void)user_data;
+#ifdef HAVE_OPENCV
+    if (widget == image_area) show_pending_source();
+#endif
+    on_size_allocate(widget, NULL, NULL);
+}
+
+// 窗口从最小化还原：各图像区仍处于映射状态，不会再收到 map，在这里补画
+static gboolean on_window_state(GtkWidget *widget, GdkEventWindowState *event, gpointer user_data) {
+    (void)widget; (void)user_data;
+    if ((event->changed_mask & GDK_WINDOW_STATE_ICONIFIED) && !(event->new_window_state & GDK_WINDOW_STATE_ICONIFIED)) {
+        on_view_map(image_area, NULL);
+    }
+    return FALSE;
+}
+
 #ifdef HAVE_OPENCV
 static GdkPixbuf* pixbuf_from_rgb_mat_copy(const cv::Mat &rgb)
 {
@@ -591,51 +705,131 @@ static GdkPixbuf* pixbuf_from_rgb_mat_copy(const cv::Mat &rgb)
     return pb;
 }
 
-static void show_cv_frame(const cv::Mat &frame) {
-    // 转换为RGB格式
-    cv::Mat bgr; 
-    if (frame.channels() == 3) 
-        bgr = frame; 
-    else 
-        cv::cvtColor(frame, bgr, cv::COLOR_GRAY2BGR);
-    
-    cv::Mat rgb; 
-    cv::cvtColor(bgr, rgb, cv::COLOR_BGR2RGB);
-    
-    // 显示原始图像（不限制大小，让滚动窗口和自适应缩放处理）
-    GdkPixbuf *pb = pixbuf_from_rgb_mat_copy(rgb);
+// 源帧按 scale_pixbuf_to_fit 的规则缩到 max_w×max_h 以内，颜色转换直接写进 pixbuf
+static GdkPixbuf* render_source_view(const cv::Mat &frame, int max_w, int max_h) {
+    if (frame.empty() || max_w <= 0 || max_h <= 0) return NULL;
+    int w, h;
+    render_fit_size(frame.cols, frame.rows, max_w, max_h, &w, &h);
+    GdkPixbuf *pb = g_view_pixbufs.acquire(w, h);
+    if (!pb) return NULL;
+    cv::Mat small;
+    const int interp = (w < frame.cols) ? cv::INTER_AREA : cv::INTER_LINEAR;
+    cv::resize(frame, small, cv::Size(w, h), 0, 0, interp);
+    cv::Mat dst(h, w, CV_8UC3, gdk_pixbuf_get_pixels(pb), (size_t)gdk_pixbuf_get_rowstride(pb));
+    cv::cvtColor(small, dst, small.channels() == 1 ? cv::COLOR_GRAY2RGB : cv::COLOR_BGR2RGB);
+    return pb;
+}
+
+static uint32_t elapsed_us(std::chrono::steady_clock::time_point t0) {
+    return (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - t0).count();
+}
+
+// 当前线程最近一次 process_original_to_imo 的分阶段耗时；未定义 PIPELINE_PROFILE 时全为 0
+static FrameTiming frame_timing_capture() {
+    FrameTiming t;
+#ifdef PIPELINE_PROFILE
+    for (int i = 0; i < PIPELINE_STAGE_COUNT; ++i) t.stage_us[i] = (uint32_t)(pipeline_frame_stages.ns[i] / 1000);
+#endif
+    return t;
+}
+
+// 源帧视图不可见时跳过渲染，记下待补画的内容：视频帧留一份源帧，归档帧补画 original_bi_image
+static cv::Mat g_source_pending;
+static bool g_source_pending_archive = false;
+
+static void source_view_render_archive() {
+    GtkAllocation alloc;
+    gtk_widget_get_allocation(image_area, &alloc);
+    int max_w = alloc.width > 50 ? alloc.width - 20 : 800;
+    int max_h = alloc.height > 50 ? alloc.height - 20 : 600;
+    GdkPixbuf *pb = render_array_pixbuf_fit(original_bi_image, bw_palette(), max_w, max_h);
     if (pb) {
-        // 获取image_area的分配大小，自适应缩放
-        GtkAllocation alloc;
-        gtk_widget_get_allocation(image_area, &alloc);
-        int max_w = alloc.width > 50 ? alloc.width - 20 : 800;
-        int max_h = alloc.height > 50 ? alloc.height - 20 : 600;
-        
-        GdkPixbuf *display_pb = scale_pixbuf_to_fit(pb, max_w, max_h);
-        if (display_pb) {
-            gtk_image_set_from_pixbuf(GTK_IMAGE(image_area), display_pb);
-            g_object_unref(display_pb);
-        }
-        
-        // 用于二值化的 pixbuf（固定为 TARGET_WIDTH x TARGET_HEIGHT）
-        GdkPixbuf *scaled = gdk_pixbuf_scale_simple(pb, TARGET_WIDTH, TARGET_HEIGHT, GDK_INTERP_BILINEAR);
-        if (scaled) {
-            pixbuf_to_binary_array(scaled);
-            g_object_unref(scaled);
-        }
-        
+        gtk_image_set_from_pixbuf(GTK_IMAGE(image_area), pb);
         g_object_unref(pb);
-        
-        // 设置当前帧索引（让动态日志知道当前帧号）
-        log_set_current_frame(g_frame_index);
-        
-        // 自动处理图像：从 original 转换为 imo
-        allocate_imo_array();
-        process_original_to_imo(&original_bi_image[0][0], &imo[0][0], IMAGE_W, IMAGE_H);
-        
-        refresh_all_views();
     }
+}
+
+// “原始输入图”区域显示源帧；看不见时只记下，不缩放不转色
+static void show_source_frame(const cv::Mat &frame) {
+    g_source_pending_archive = false;
+    if (!view_visible(image_area)) {
+        g_source_pending = own_frame(frame);
+        return;
+    }
+    g_source_pending.release();
+    const auto t0 = std::chrono::steady_clock::now();
+    GtkAllocation alloc;
+    gtk_widget_get_allocation(image_area, &alloc);
+    int max_w = alloc.width > 50 ? alloc.width - 20 : 800;
+    int max_h = alloc.height > 50 ? alloc.height - 20 : 600;
+    GdkPixbuf *pb = render_source_view(frame, max_w, max_h);
+    if (pb) {
+        gtk_image_set_from_pixbuf(GTK_IMAGE(image_area), pb);
+        g_object_unref(pb);
+    }
+    g_source_render_us += elapsed_us(t0);
+}
+
+// 源帧视图重新可见：补画跳过的那一帧
+static void show_pending_source() {
+    if (!view_visible(image_area)) return;
+    if (g_source_pending_archive) {
+        g_source_pending_archive = false;
+        source_view_render_archive();
+    } else if (!g_source_pending.empty()) {
+        const cv::Mat frame = g_source_pending;
+        show_source_frame(frame);
+        g_source_render_us = 0;  // 补画不算当前帧的渲染耗时
+    }
+}
+
+// 当前帧（g_frame_index）送 A/B 对比窗口；须在界面线程处理该帧之前调用，此时 watch 还是上一帧的
+static void ab_submit_frame(const cv::Mat &frame) {
+#if AB_COMPARE
+    AbCompareWindow *ab = g_ab.load(std::memory_order_relaxed);
+    if (ab && ab->active()) ab->submitFrame(own_frame(frame), g_frame_index, watch);
+#else
+    (void)frame;
+#endif
+}
+
+static void ab_submit_original() {
+#if AB_COMPARE
+    AbCompareWindow *ab = g_ab.load(std::memory_order_relaxed);
+    if (ab && ab->active()) ab->submitBinary(original_bi_image, g_frame_index, watch);
+#endif
+}
+
+static void show_cv_frame(const cv::Mat &frame) {
+    show_source_frame(frame);
+    ab_submit_frame(frame);
+    
+    // 直接从源帧缩放 + 二值化到 original_bi_image（与 video_processor 共用同一内核）
+    binarize_mat_to_original(frame);
+    run_pipeline_on_original();
+}
+
+// original_bi_image 已就绪：跑一遍处理流程并刷新图像、日志与示波器
+static void run_pipeline_on_original() {
+    // 设置当前帧索引（让动态日志知道当前帧号）
+    log_set_current_frame(g_frame_index);
+    
+    // 自动处理图像：从 original 转换为 imo
+    allocate_imo_array();
+    process_original_to_imo(&original_bi_image[0][0], &imo[0][0], IMAGE_W, IMAGE_H);
+    g_frame_timing = frame_timing_capture();
     
+    const auto t0 = std::chrono::steady_clock::now();
+    refresh_all_views();
+    g_frame_timing.render_us = g_source_render_us + elapsed_us(t0);
+    g_source_render_us = 0;
+    timing_panel_show(g_frame_timing, true);
+    update_frame_panels();
+}
+
+// 当前帧的日志与示波器
+static void update_frame_panels() {
     // 更新日志显示
     update_log_display(g_frame_index);
     
@@ -645,6 +839,502 @@ static void show_cv_frame(const cv::Mat &frame) {
     }
 }
 
+// ---------------- 分阶段耗时面板 ----------------
+// - 每行一个阶段：本帧耗时与最近 TIMING_WINDOW 帧的 p50 / p99（µs）
+// - 流水线各阶段来自 process_original_to_imo / image_process 的打点，未定义 PIPELINE_PROFILE 时
+//   打点编译为空，面板只有 render 一行有数；render 是三个图像区渲染到显示尺寸的耗时
+// - 预取帧的耗时在预取线程里测，随结果带回；缓存命中的帧显示处理时记下的耗时，不重复计入统计
+// - 最后一行是自上一帧显示以来新分配的显示 pixbuf 数（次），视图尺寸不变时应为 0
+static const int TIMING_WINDOW = 120;
+enum { TIMING_ROW_RENDER = PIPELINE_STAGE_COUNT, TIMING_ROW_TOTAL, TIMING_ROW_ALLOCS, TIMING_ROW_COUNT };
+
+struct TimingRow {
+    GtkWidget *cur = NULL, *p50 = NULL, *p99 = NULL;
+    uint32_t window[TIMING_WINDOW] = {};   // 环形，最近 count 帧
+    int count = 0;
+    int next = 0;
+};
+static TimingRow g_timing_rows[TIMING_ROW_COUNT];
+static size_t g_timing_alloc_mark = 0;  // 上一帧显示时 g_view_pixbufs 的累计分配次数
+
+static GtkWidget *timing_value_label() {
+    GtkWidget *label = gtk_label_new("-");
+    gtk_widget_set_halign(label, GTK_ALIGN_END);
+    return label;
+}
+
+static GtkWidget *timing_panel_new() {
+#ifdef PIPELINE_PROFILE
+    GtkWidget *frame = gtk_frame_new("阶段耗时 (µs)");
+#else
+    GtkWidget *frame = gtk_frame_new("阶段耗时 (µs，未启用 PIPELINE_PROFILE)");
+#endif
+    gtk_frame_set_shadow_type(GTK_FRAME(frame), GTK_SHADOW_ETCHED_IN);
+    GtkWidget *grid = gtk_grid_new();
+    gtk_grid_set_column_spacing(GTK_GRID(grid), 16);
+    gtk_container_set_border_width(GTK_CONTAINER(grid), 4);
+
+    const char *heads[] = {"阶段", "本帧", "p50", "p99"};
+    for (int c = 0; c < 4; ++c) {
+        GtkWidget *label = gtk_label_new(heads[c]);
+        gtk_widget_set_halign(label, c == 0 ? GTK_ALIGN_START : GTK_ALIGN_END);
+        gtk_grid_attach(GTK_GRID(grid), label, c, 0, 1, 1);
+    }
+    for (int r = 0; r < TIMING_ROW_COUNT; ++r) {
+        const char *name = r < PIPELINE_STAGE_COUNT ? pipeline_stage_name(r)
+                         : r == TIMING_ROW_RENDER ? "render"
+                         : r == TIMING_ROW_TOTAL ? "合计" : "pixbuf 分配(次)";
+        GtkWidget *label = gtk_label_new(name);
+        gtk_widget_set_halign(label, GTK_ALIGN_START);
+        TimingRow &row = g_timing_rows[r];
+        row.cur = timing_value_label();
+        row.p50 = timing_value_label();
+        row.p99 = timing_value_label();
+        gtk_grid_attach(GTK_GRID(grid), label, 0, r + 1, 1, 1);
+        gtk_grid_attach(GTK_GRID(grid), row.cur, 1, r + 1, 1, 1);
+        gtk_grid_attach(GTK_GRID(grid), row.p50, 2, r + 1, 1, 1);
+        gtk_grid_attach(GTK_GRID(grid), row.p99, 3, r + 1, 1, 1);
+    }
+    gtk_container_add(GTK_CONTAINER(frame), grid);
+    return frame;
+}
+
+static void timing_row_show(TimingRow &row, uint32_t us, bool record) {
+    gtk_label_set_text(GTK_LABEL(row.cur), std::to_string(us).c_str());
+    if (record) {
+        row.window[row.next] = us;
+        row.next = (row.next + 1) % TIMING_WINDOW;
+        if (row.count < TIMING_WINDOW) ++row.count;
+    }
+    if (row.count == 0) return;
+    // 未满时有效数据正好是前 count 个；120 个数排序的开销可忽略
+    uint32_t sorted[TIMING_WINDOW];
+    std::copy(row.window, row.window + row.count, sorted);
+    std::sort(sorted, sorted + row.count);
+    gtk_label_set_text(GTK_LABEL(row.p50), std::to_string(sorted[(row.count - 1) * 50 / 100]).c_str());
+    gtk_label_set_text(GTK_LABEL(row.p99), std::to_string(sorted[(row.count - 1) * 99 / 100]).c_str());
+}
+
+// 显示一帧的耗时；record 为 false 时只更新“本帧”列
+static void timing_panel_show(const FrameTiming &t, bool record) {
+    if (!g_timing_rows[0].cur) return;
+    uint32_t total = t.render_us;
+#ifdef PIPELINE_PROFILE
+    for (int i = 0; i < PIPELINE_STAGE_COUNT; ++i) {
+        timing_row_show(g_timing_rows[i], t.stage_us[i], record);
+        total += t.stage_us[i];
+    }
+#endif
+    timing_row_show(g_timing_rows[TIMING_ROW_RENDER], t.render_us, record);
+    timing_row_show(g_timing_rows[TIMING_ROW_TOTAL], total, record);
+
+    const size_t allocs = g_view_pixbufs.allocations();
+    timing_row_show(g_timing_rows[TIMING_ROW_ALLOCS], (uint32_t)(allocs - g_timing_alloc_mark), record);
+    g_timing_alloc_mark = allocs;
+}
+
+// 归档第 index 帧（从 0 开始）直接解包到 original_bi_image，不经过任何解码
+static bool show_archive_frame(int index) {
+    if (!g_archive.map.base || index < 0 || index >= (int)g_archive.count) return false;
+    frame_archive_unpack_u8(&g_archive, (uint32_t)index, &original_bi_image[0][0], IMAGE_W);
+    g_archive_pos = index;
+    frame_archive_meta meta;
+    g_frame_index = frame_archive_read_meta(&g_archive, (uint32_t)index, &meta) == 0 ? (int)meta.frame_id : index + 1;
+
+    // 归档里没有原始彩色帧，“原始输入图”区域显示二值帧本身
+    g_source_pending.release();
+    g_source_pending_archive = !view_visible(image_area);
+    if (!g_source_pending_archive) {
+        const auto t0 = std::chrono::steady_clock::now();
+        source_view_render_archive();
+        g_source_render_us += elapsed_us(t0);
+    }
+    ab_submit_original();
+    run_pipeline_on_original();
+    return true;
+}
+
+#if PLAYBACK_PREFETCH
+// ---------------- 播放预取：后台线程解码 + 处理，定时器只换帧 ----------------
+// - 播放期间 g_cap 归预取线程独占（改动帧源的操作都先 stop_playback）；停播后把 g_cap
+//   定位回最后显示的帧之后，单步、拖动与原来一致
+// - 预取线程有自己的一份流水线全局状态：开播时带入界面线程的 watch，每帧把处理后的 watch、
+//   original/imo 与动态日志随结果交回，换帧时写回界面线程，停播后单步处理接着显示的那一帧继续
+// - 三个图像区直接在预取线程里渲染到显示尺寸，定时器里只剩 gtk_image_set_from_pixbuf
+// - 结果放进容量 PREFETCH_DEPTH 的有界队列，满则预取线程阻塞；预取线程与定时器共用 g_clock 的
+//   显示时刻，允许丢帧时已经来不及显示的帧只 grab 不处理
+static const size_t PREFETCH_DEPTH = 4;
+
+struct PixbufUnref {
+    void operator()(GdkPixbuf *pb) const { if (pb) g_object_unref(pb); }
+};
+typedef std::unique_ptr<GdkPixbuf, PixbufUnref> PixbufPtr;
+
+struct PrefetchedFrame {
+    long long seq = 0;                    // 播放序号，决定显示时刻
+    int frame_index = 0;                  // 帧号，换帧后写入 g_frame_index
+    int archive_pos = -1;                 // 归档模式下的帧位置（从 0 开始）
+    PixbufPtr source_view, original_view, imo_view;  // 对应图像区不可见时为空
+    cv::Mat hidden_source;                // 视频帧的源帧视图不可见时留下源帧，重新可见时补画
+    uint8_t original[IMAGE_H][IMAGE_W];
+    uint8_t imo[IMAGE_H][IMAGE_W];
+    struct watch_o watch;
+    std::vector<DynamicLogVariable> logs;
+    FrameTiming timing;                   // 预取线程里测的处理与渲染耗时
+    cv::Mat ab_frame;                     // A/B 对比窗口开着时留下的视频帧，换帧时送去对比
+    struct watch_o ab_watch;              // 处理该帧之前的 watch
+};
+
+// 图像区可用尺寸（界面线程每次换帧前更新，预取线程按此渲染）
+struct ViewBox {
+    std::atomic<int> w{0};
+    std::atomic<int> h{0};
+};
+
+struct PrefetchSession {
+    BoundedQueue<std::unique_ptr<PrefetchedFrame>> ring{PREFETCH_DEPTH};
+    std::atomic<bool> finished{false};    // 帧源已读完，ring 里剩下的就是最后几帧
+    std::atomic<int> dropped{0};
+    int frame_count = 0;                  // 播放期间不能再访问 g_cap，开播时记下
+    double fps = 0.0;
+    ViewBox source_box, original_box, imo_box;
+    std::unique_ptr<PrefetchedFrame> due; // 已取出、还没到显示时刻的一帧（仅界面线程）
+    std::thread worker;
+};
+
+static std::unique_ptr<PrefetchSession> g_prefetch;  // 非空即正在预取
+#endif
+
+// ---------------- 帧源：视频或帧归档 ----------------
+static bool archive_active() { return g_archive.map.base != NULL; }
+
+static bool playback_source_open() { return archive_active() || g_cap.isOpened(); }
+
+static int playback_frame_count() {
+    if (archive_active()) return (int)g_archive.count;
+#if PLAYBACK_PREFETCH
+    if (g_prefetch) return g_prefetch->frame_count;
+#endif
+    return (int)g_cap.get(cv::CAP_PROP_FRAME_COUNT);
+}
+
+// 已显示的帧数（1 起），用于进度条与播放结束判断
+static int playback_position() {
+    return archive_active() ? g_archive_pos + 1 : g_frame_index;
+}
+
+static double playback_fps() {
+#if PLAYBACK_PREFETCH
+    if (g_prefetch) return g_prefetch->fps;
+#endif
+    double fps = archive_active() ? 0.0 : g_cap.get(cv::CAP_PROP_FPS);
+    return fps > 0 ? fps : 25.0; // 默认25fps
+}
+
+// ---------------- 视频帧缓存 ----------------
+// - 显示过的帧连同处理结果（original/imo/watch/动态日志）一起缓存，再次显示时直接还原，
+//   不重新解码也不重新处理
+// - 缓存未命中且要往回跳（或向前跳得较远）时，从目标前 FRAME_CACHE_BACKFILL 帧处定位，连续解码到
+//   目标帧，途经的帧都进缓存：后端定位本来就要从前一个关键帧解码到目标帧，这一段几乎不多花时间，
+//   之后逐帧后退全部命中
+// - 占用按解码帧字节数计，按最久未用淘汰
+static const int FRAME_CACHE_BACKFILL = 30;
+
+static size_t cached_frame_cost(const cv::Mat &frame) {
+    return frame.step[0] * (size_t)frame.rows + sizeof(CachedFrame);
+}
+
+// 放入缓存前脱离解码器缓冲（仅亮度解码得到的是整块 YUV 的行区间视图）
+static cv::Mat own_frame(const cv::Mat &frame) {
+    return frame.isSubmatrix() ? frame.clone() : frame;
+}
+
+// 记下当前帧的处理结果
+static void frame_cache_capture(CachedFrame &c) {
+    memcpy(c.original, original_bi_image, sizeof(c.original));
+    memcpy(c.imo, imo, sizeof(c.imo));
+    c.watch = watch;
+    c.logs = DynamicLogManager::getInstance().getFrameLogs(g_frame_index);
+    c.timing = g_frame_timing;
+    c.processed = true;
+}
+
+// 还原缓存的处理结果并刷新各视图
+static void frame_cache_restore(const CachedFrame &c) {
+    memcpy(original_bi_image, c.original, sizeof(c.original));
+    memcpy(imo, c.imo, sizeof(c.imo));
+    watch = c.watch;
+    DynamicLogManager::getInstance().setFrameLogs(g_frame_index, c.logs);
+    log_set_current_frame(g_frame_index);
+    refresh_all_views();
+    g_frame_timing = c.timing;
+    g_source_render_us = 0;
+    timing_panel_show(c.timing, false);
+    update_frame_panels();
+}
+
+// 显示视频第 index 帧（从 0 开始）
+static bool show_video_frame(int index) {
+    if (index < 0) return false;
+    if (CachedFrame *c = g_frame_cache.find(index)) {
+        g_frame_index = index + 1;
+        show_source_frame(c->frame);
+        ab_submit_frame(c->frame);
+        if (c->processed) {
+            frame_cache_restore(*c);
+        } else {
+            binarize_mat_to_original(c->frame);
+            run_pipeline_on_original();
+            frame_cache_capture(*c);
+        }
+        return true;
+    }
+
+    if (index < g_cap_next || index > g_cap_next + FRAME_CACHE_BACKFILL) {
+        const int start = index >= FRAME_CACHE_BACKFILL ? index - FRAME_CACHE_BACKFILL + 1 : 0;
+        g_cap.set(cv::CAP_PROP_POS_FRAMES, start);
+        g_cap_next = start;
+    }
+    cv::Mat frame;
+    while (g_cap_next <= index) {
+        if (!g_cap.read(frame)) return false;
+        const int at = g_cap_next++;
+        if (at < index && !g_frame_cache.contains(at)) {
+            CachedFrame c;
+            c.frame = own_frame(frame);
+            const size_t cost = cached_frame_cost(c.frame);
+            g_frame_cache.put(at, std::move(c), cost);
+        }
+    }
+
+    g_frame_index = index + 1;
+    show_cv_frame(frame);
+    CachedFrame c;
+    c.frame = own_frame(frame);
+    frame_cache_capture(c);
+    const size_t cost = cached_frame_cost(c.frame);
+    g_frame_cache.put(index, std::move(c), cost);
+    return true;
+}
+
+// 工具栏调整缓存上限；调小立即淘汰
+static void frame_cache_size_changed(GtkSpinButton *spin, gpointer data) {
+    (void)data;
+    g_frame_cache.set_capacity((size_t)gtk_spin_button_get_value_as_int(spin) << 20);
+}
+
+// 跳到第 index 帧（从 0 开始）并显示
+static bool playback_seek(int index) {
+    if (archive_active()) return show_archive_frame(index);
+    return show_video_frame(index);
+}
+
+static bool playback_next() {
+    if (archive_active()) return show_archive_frame(g_archive_pos + 1);
+    return show_video_frame(g_frame_index);
+}
+
+#if PLAYBACK_PREFETCH
+// 不可见的图像区尺寸记为 0，预取线程就不渲染它
+static void view_box_update(ViewBox &box, GtkWidget *widget, int def_w, int def_h) {
+    if (!view_visible(widget)) {
+        box.w.store(0, std::memory_order_relaxed);
+        box.h.store(0, std::memory_order_relaxed);
+        return;
+    }
+    GtkAllocation alloc;
+    gtk_widget_get_allocation(widget, &alloc);
+    box.w.store(alloc.width > 50 ? alloc.width - 20 : def_w, std::memory_order_relaxed);
+    box.h.store(alloc.height > 50 ? alloc.height - 20 : def_h, std::memory_order_relaxed);
+}
+
+static void prefetch_update_view_boxes(PrefetchSession &s) {
+    view_box_update(s.source_box, image_area, 800, 600);
+    view_box_update(s.original_box, original_array_area, 400, 300);
+    view_box_update(s.imo_box, imo_image_view, 400, 300);
+}
+
+static PixbufPtr render_view(uint8_t arr[IMAGE_H][IMAGE_W], const render_palette *pal, const ViewBox &box) {
+    return PixbufPtr(render_array_pixbuf_fit(arr, pal, box.w.load(std::memory_order_relaxed),
+                                             box.h.load(std::memory_order_relaxed)));
+}
+
+// 预取线程：从 next_archive_pos（归档）或 g_cap 当前位置（视频）起逐帧处理，直到读完或停止
+static void prefetch_worker(PrefetchSession *s, struct watch_o start_watch, int next_archive_pos,
+                            int frame_index, PlaybackClock clock, bool allow_drop) {
+    watch = start_watch;
+    const bool from_archive = archive_active();
+    for (long long k = clock.seq;; ++k) {
+        // 第 k 帧在 t0 + (k+1) 个间隔时显示；已经过了就跳过，让播放追上实时
+        if (allow_drop && k > clock.seq && std::chrono::steady_clock::now() > clock.t0 + clock.interval * (k + 1)) {
+            if (from_archive) {
+                if (next_archive_pos >= (int)g_archive.count) break;
+                ++next_archive_pos;
+            } else {
+                if (!g_cap.grab()) break;
+                ++frame_index;
+            }
+            s->dropped.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+
+        std::unique_ptr<PrefetchedFrame> f(new PrefetchedFrame());
+        f->seq = k;
+        std::chrono::steady_clock::time_point t0;
+        uint32_t render_us = 0;  // 源帧视图渲染
+        if (from_archive) {
+            if (next_archive_pos >= (int)g_archive.count) break;
+            frame_archive_unpack_u8(&g_archive, (uint32_t)next_archive_pos, &original_bi_image[0][0], IMAGE_W);
+            frame_archive_meta meta;
+            f->frame_index = frame_archive_read_meta(&g_archive, (uint32_t)next_archive_pos, &meta) == 0
+                ? (int)meta.frame_id : next_archive_pos + 1;
+            f->archive_pos = next_archive_pos++;
+            t0 = std::chrono::steady_clock::now();
+            f->source_view = render_view(original_bi_image, bw_palette(), s->source_box);
+            render_us = elapsed_us(t0);
+        } else {
+            cv::Mat frame;
+            if (!g_cap.read(frame)) break;
+            f->frame_index = ++frame_index;
+            t0 = std::chrono::steady_clock::now();
+            f->source_view = PixbufPtr(render_source_view(frame, s->source_box.w.load(std::memory_order_relaxed),
+                                                          s->source_box.h.load(std::memory_order_relaxed)));
+            render_us = elapsed_us(t0);
+            if (!f->source_view) f->hidden_source = own_frame(frame);
+#if AB_COMPARE
+            AbCompareWindow *ab = g_ab.load(std::memory_order_relaxed);
+            if (ab && ab->active()) f->ab_frame = f->hidden_source.empty() ? own_frame(frame) : f->hidden_source;
+#endif
+            binarize_mat_to_original(frame);
+        }
+
+        f->ab_watch = watch;
+        log_set_current_frame(f->frame_index);
+        allocate_imo_array();
+        process_original_to_imo(&original_bi_image[0][0], &imo[0][0], IMAGE_W, IMAGE_H);
+
+        memcpy(f->original, original_bi_image, sizeof(f->original));
+        memcpy(f->imo, imo, sizeof(f->imo));
+        f->watch = watch;
+        f->logs = DynamicLogManager::getInstance().takeFrameLogs(f->frame_index);
+        f->timing = frame_timing_capture();
+        t0 = std::chrono::steady_clock::now();
+        f->original_view = render_view(f->original, bw_palette(), s->original_box);
+        f->imo_view = render_view(f->imo, imo_palette(), s->imo_box);
+        f->timing.render_us = render_us + elapsed_us(t0);
+        if (!s->ring.push(std::move(f))) return;  // 已停止播放
+    }
+    s->finished.store(true);
+    s->ring.close();
+}
+
+static void prefetch_start() {
+    // 缓存命中时 g_cap 没有跟着走，先对齐到当前帧之后
+    if (!archive_active() && g_cap_next != g_frame_index) {
+        g_cap.set(cv::CAP_PROP_POS_FRAMES, g_frame_index);
+        g_cap_next = g_frame_index;
+    }
+    std::unique_ptr<PrefetchSession> s(new PrefetchSession());
+    s->frame_count = playback_frame_count();
+    s->fps = playback_fps();
+    prefetch_update_view_boxes(*s);
+    s->worker = std::thread(prefetch_worker, s.get(), watch, g_archive_pos + 1, g_frame_index,
+                            g_clock, g_allow_drop != FALSE);
+    g_prefetch = std::move(s);
+}
+
+static void prefetch_stop() {
+    if (!g_prefetch) return;
+    g_prefetch->ring.close();
+    g_prefetch->worker.join();
+    g_prefetch.reset();
+    // 预取线程读到的后续帧作废，视频回到最后显示的帧之后
+    if (!archive_active() && g_cap.isOpened()) {
+        g_cap.set(cv::CAP_PROP_POS_FRAMES, g_frame_index);
+        g_cap_next = g_frame_index;
+    }
+}
+
+// 下一帧预取结果（取出后留在 s.due 直到显示）；还没有时返回 NULL，ended 表示帧源已播完
+static PrefetchedFrame *prefetch_peek(bool *ended) {
+    *ended = false;
+    PrefetchSession &s = *g_prefetch;
+    if (!s.due && !s.ring.try_pop(s.due)) {
+        // 先看 finished 再看队列：finished 在最后一帧入队之后才置位
+        *ended = s.finished.load() && s.ring.size() == 0;
+        return NULL;
+    }
+    return s.due.get();
+}
+
+// 换上 s.due 这一帧
+static void prefetch_show_due() {
+    PrefetchSession &s = *g_prefetch;
+    std::unique_ptr<PrefetchedFrame> f = std::move(s.due);
+    prefetch_update_view_boxes(s);
+
+    g_frame_index = f->frame_index;
+    if (f->archive_pos >= 0) g_archive_pos = f->archive_pos;
+#if AB_COMPARE
+    if (AbCompareWindow *ab = g_ab.load(std::memory_order_relaxed)) {
+        if (f->archive_pos >= 0) ab->submitBinary(f->original, f->frame_index, f->ab_watch);
+        else ab->submitFrame(f->ab_frame, f->frame_index, f->ab_watch);
+    }
+#endif
+    memcpy(original_bi_image, f->original, sizeof(f->original));
+    memcpy(imo, f->imo, sizeof(f->imo));
+    watch = f->watch;
+    DynamicLogManager::getInstance().setFrameLogs(f->frame_index, std::move(f->logs));
+
+    g_source_pending = f->hidden_source;
+    g_source_pending_archive = false;
+    if (f->source_view) gtk_image_set_from_pixbuf(GTK_IMAGE(image_area), f->source_view.get());
+    else if (f->archive_pos >= 0) g_source_pending_archive = true;
+    if (f->original_view && original_array_area)
+        gtk_image_set_from_pixbuf(GTK_IMAGE(original_array_area), f->original_view.get());
+    if (f->imo_view && imo_image_view)
+        gtk_image_set_from_pixbuf(GTK_IMAGE(imo_image_view), f->imo_view.get());
+    g_frame_timing = f->timing;
+    timing_panel_show(f->timing, true);
+    update_frame_panels();
+}
+#endif
+
+static void open_archive_clicked(GtkWidget *widget, gpointer data) {
+    GtkWidget *dialog = gtk_file_chooser_dialog_new("选择帧归档", GTK_WINDOW(window), GTK_FILE_CHOOSER_ACTION_OPEN,
+                                                   "_取消", GTK_RESPONSE_CANCEL, "_打开", GTK_RESPONSE_ACCEPT, NULL);
+    GtkFileFilter *filter = gtk_file_filter_new();
+    gtk_file_filter_set_name(filter, "帧归档 (*.ipfa)");
+    gtk_file_filter_add_pattern(filter, "*.ipfa");
+    gtk_file_chooser_add_filter(GTK_FILE_CHOOSER(dialog), filter);
+    if (gtk_dialog_run(GTK_DIALOG(dialog)) == GTK_RESPONSE_ACCEPT) {
+        char *filename = gtk_file_chooser_get_filename(GTK_FILE_CHOOSER(dialog));
+        stop_playback();
+        frame_archive_close(&g_archive);
+        g_archive_pos = -1;
+        const char *msg = NULL;
+        if (!filename || frame_archive_open(&g_archive, filename) != 0) {
+            msg = "无法打开帧归档";
+        } else if (g_archive.header.width != IMAGE_W || g_archive.header.height != IMAGE_H) {
+            msg = "归档帧尺寸与 IMAGE_W×IMAGE_H 不一致";
+        } else if (g_archive.count == 0) {
+            msg = "归档中没有帧";
+        }
+        if (msg) {
+            frame_archive_close(&g_archive);
+            GtkWidget *err = gtk_message_dialog_new(GTK_WINDOW(window), GTK_DIALOG_DESTROY_WITH_PARENT,
+                                                    GTK_MESSAGE_ERROR, GTK_BUTTONS_CLOSE, "%s", msg);
+            gtk_dialog_run(GTK_DIALOG(err)); gtk_widget_destroy(err);
+        } else {
+            if (g_cap.isOpened()) g_cap.release(); // 归档代替视频作为帧源
+            show_archive_frame(0);
+            update_progress_bar();
+        }
+        g_free(filename);
+    }
+    gtk_widget_destroy(dialog);
+}
+
 static void load_log_csv_clicked(GtkWidget *widget, gpointer data) {
     GtkWidget *dialog = gtk_file_chooser_dialog_new("选择日志CSV文件", GTK_WINDOW(window), 
                                                       GTK_FILE_CHOOSER_ACTION_OPEN,
@@ -702,92 +1392,27 @@ static void load_log_csv_clicked(GtkWidget *widget, gpointer data) {
 }
 
 static void update_log_display(int frame_index) {
-    if (!g_log_buffer) return;
+    if (!g_log_panel) return;
     
     // 更新动态日志管理器的当前帧
     log_set_current_frame(frame_index);
     
-    // 清空当前内容
-    gtk_text_buffer_set_text(g_log_buffer, "", -1);
-    
-    // 检查日志来源
-    bool has_csv_logs = (g_csv_reader.getRecordCount() > 0);
-    std::vector<DynamicLogVariable> dynamic_logs = DynamicLogManager::getInstance().getFrameLogs(frame_index);
-    bool has_dynamic_logs = !dynamic_logs.empty();
-    
-    // 如果既没有CSV也没有动态日志
-    if (!has_csv_logs && !has_dynamic_logs) {
-        gtk_text_buffer_set_text(g_log_buffer, 
-            "未加载日志文件\n"
-            "━━━━━━━━━━━━━━━━━━━━━━━━━━━\n"
-            "• 点击\"加载日志CSV\"加载文件\n"
-            "• 或在代码中使用 log_add_*() 函数添加日志", -1);
-        return;
-    }
-    
-    // 构建显示文本
-    std::string display_text;
-    display_text += "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n";
-    display_text += "  当前帧: " + std::to_string(frame_index);
-    if (has_csv_logs) {
-        display_text += " / " + std::to_string(g_csv_reader.getRecordCount());
-    }
-    display_text += "\n";
-    display_text += "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n\n";
-    
-    // ======== 显示动态日志（优先级更高） ========
-    if (has_dynamic_logs) {
-        display_text += "🔧 动态日志 (代码添加):\n";
-        for (const auto& var : dynamic_logs) {
-            display_text += "  • " + var.name + ": " + var.value_str + "\n";
-        }
-        display_text += "\n";
-    }
-    
-    // ======== 显示CSV日志 ========
-    if (has_csv_logs) {
-        // 获取对应帧的日志（假设帧索引从1开始，CSV记录从0开始）
-        int log_index = frame_index - 1;
-        if (log_index < 0) log_index = 0;
-        
-        if (log_index >= g_csv_reader.getRecordCount()) {
-            display_text += "⚠️  当前帧超出CSV日志范围\n\n";
-        } else {
-            LogRecord record = g_csv_reader.getLogByIndex(log_index);
-            
-            display_text += "⏰ 时间戳:\n  " + record.timestamp + "\n\n";
-            
-            // 显示自定义变量
-            std::vector<std::string> varNames = g_csv_reader.getVariableNames();
-            if (!varNames.empty()) {
-                display_text += "📊 CSV日志变量:\n";
-                for (const auto& varName : varNames) {
-                    auto it = record.variables.find(varName);
-                    if (it != record.variables.end()) {
-                        display_text += "  • " + varName + ": " + it->second + "\n";
-                    }
-                }
-                display_text += "\n";
-            }
-            
-            // 显示原始数据
-            if (!record.log_utf8.empty()) {
-                display_text += "📝 UTF-8文本:\n  " + record.log_utf8 + "\n\n";
-            }
-    
-            if (!record.log_hex.empty()) {
-                display_text += "🔧 Hex数据:\n  ";
-                // 格式化hex显示，每32个字符换行
-                for (size_t i = 0; i < record.log_hex.length(); i += 32) {
-                    if (i > 0) display_text += "  ";
-                    display_text += record.log_hex.substr(i, 32) + "\n";
-                }
-            }
-        }
+    // 按帧查日志不复制，面板只改值变了的行
+    g_log_panel->update(frame_index, DynamicLogManager::getInstance().findFrameLogs(frame_index), g_csv_reader);
+}
+
+#if AB_COMPARE
+// 打开 A/B 对比窗口：从下一次换帧起两路同时处理
+static void open_ab_compare_clicked(GtkWidget *widget, gpointer data) {
+    (void)widget; (void)data;
+    AbCompareWindow *ab = g_ab.load();
+    if (!ab) {
+        ab = new AbCompareWindow();
+        g_ab.store(ab);
     }
-    
-    gtk_text_buffer_set_text(g_log_buffer, display_text.c_str(), -1);
+    ab->show();
 }
+#endif
 
 // 打开示波器窗口
 static void open_oscilloscope_clicked(GtkWidget *widget, gpointer data) {
@@ -813,61 +1438,129 @@ static void open_oscilloscope_clicked(GtkWidget *widget, gpointer data) {
     }
 }
 
-static void show_cv_frame_OLD(const cv::Mat &frame) {
-    // 左侧显示原始帧（安全复制到 GdkPixbuf）
-    cv::Mat bgr; if (frame.channels()==3) bgr = frame; else cv::cvtColor(frame, bgr, cv::COLOR_GRAY2BGR);
-    cv::Mat rgb; cv::cvtColor(bgr, rgb, cv::COLOR_BGR2RGB);
-    GdkPixbuf *pb = pixbuf_from_rgb_mat_copy(rgb);
-    if (pb) {
-        gtk_image_set_from_pixbuf(GTK_IMAGE(image_area), pb);
-        // 生成 188x120 的 pixbuf 用于二值化
-        GdkPixbuf *scaled = gdk_pixbuf_scale_simple(pb, TARGET_WIDTH, TARGET_HEIGHT, GDK_INTERP_BILINEAR);
-        g_object_unref(pb);
-        if (scaled) {
-            pixbuf_to_binary_array(scaled);
-            g_object_unref(scaled);
-            
-            // 自动处理图像：从 original 转换为 imo
-            allocate_imo_array();
-            process_original_to_imo(&original_bi_image[0][0], &imo[0][0], IMAGE_W, IMAGE_H);
-            
-            refresh_all_views();
-        }
-    }
-}
-
 typedef struct ThumbData { int frame_index; GtkWidget *dialog; } ThumbData;
 
 static void on_thumb_clicked(GtkWidget *widget, gpointer user_data)
 {
     ThumbData *td = (ThumbData*)user_data;
     if (!td) return;
-    if (g_cap.isOpened()) {
+    if (playback_source_open()) {
         stop_playback(); // 停止播放
-        g_cap.set(cv::CAP_PROP_POS_FRAMES, td->frame_index);
-        cv::Mat frame; 
-        if (g_cap.read(frame)) { 
-            g_frame_index = (int)g_cap.get(cv::CAP_PROP_POS_FRAMES); 
-            show_cv_frame(frame);
-            update_progress_bar();
+        if (playback_seek(td->frame_index)) update_progress_bar();
+    }
+    if (td->dialog) gtk_widget_destroy(td->dialog); // td 随按钮一起释放
+}
+
+// ---------------- 平铺选帧的缩略图 ----------------
+// - 视频缩略图由后台线程生成：每个线程自开一个 cv::VideoCapture（不动 g_cap），按原子计数领取格子，
+//   定位、解码、缩放后交给界面线程；界面线程定时把完成的贴进对应格子，窗口打开即可操作
+// - 缩略图写入视频旁的 .thumbs 旁路缓存（thumb_cache），再次打开时先从缓存取，只补生成缺的
+// - 归档帧解包很快，仍在界面线程直接渲染
+static const int THUMB_MAX_WORKERS = 4;
+static const guint THUMB_POLL_MS = 50;
+
+struct ThumbSession {
+    std::string video_path;
+    std::vector<int> frames;                  // 各格对应的帧位置（从 0 开始，升序）
+    std::vector<GtkWidget *> images;          // 各格的 GtkImage
+    std::vector<std::vector<uint8_t>> rgb;    // 各格缩略图像素（空 = 尚未生成）；生成中的格子只归领取它的线程
+    std::vector<size_t> pending;              // 需要生成的格子
+    std::atomic<size_t> next{0};              // pending 中下一个待领取的位置
+    std::atomic<int> running{0};              // 仍在运行的生成线程数
+    std::atomic<size_t> produced{0};          // 新生成的张数，非 0 时关闭窗口写回旁路缓存
+    std::atomic<bool> cancel{false};
+    std::mutex mutex;
+    std::vector<size_t> ready;                // 已生成、待贴图的格子（受 mutex 保护）
+    std::vector<std::thread> workers;
+    guint poll_id = 0;
+};
+
+static std::unique_ptr<ThumbSession> g_thumbs;  // 选帧窗口打开期间非空
+
+static void thumb_worker(ThumbSession *s) {
+    cv::VideoCapture cap(s->video_path);
+    cv::Mat frame, small;
+    while (cap.isOpened() && !s->cancel.load()) {
+        const size_t k = s->next.fetch_add(1);
+        if (k >= s->pending.size()) break;
+        const size_t slot = s->pending[k];
+        cap.set(cv::CAP_PROP_POS_FRAMES, s->frames[slot]);
+        if (!cap.read(frame)) continue;
+        std::vector<uint8_t> rgb((size_t)TARGET_WIDTH * TARGET_HEIGHT * 3);
+        cv::resize(frame, small, cv::Size(TARGET_WIDTH, TARGET_HEIGHT), 0, 0, cv::INTER_AREA);
+        cv::Mat dst(TARGET_HEIGHT, TARGET_WIDTH, CV_8UC3, rgb.data());
+        cv::cvtColor(small, dst, small.channels() == 1 ? cv::COLOR_GRAY2RGB : cv::COLOR_BGR2RGB);
+        s->rgb[slot] = std::move(rgb);
+        s->produced.fetch_add(1);
+        std::lock_guard<std::mutex> lock(s->mutex);
+        s->ready.push_back(slot);
+    }
+    s->running.fetch_sub(1);
+}
+
+static void thumb_set_image(ThumbSession &s, size_t slot) {
+    cv::Mat rgb(TARGET_HEIGHT, TARGET_WIDTH, CV_8UC3, s.rgb[slot].data());
+    GdkPixbuf *pb = pixbuf_from_rgb_mat_copy(rgb);
+    if (!pb) return;
+    gtk_image_set_from_pixbuf(GTK_IMAGE(s.images[slot]), pb);
+    g_object_unref(pb);
+}
+
+// 界面线程：把已生成的缩略图贴进格子；全部生成完后停止
+static gboolean thumb_poll(gpointer user_data) {
+    (void)user_data;
+    ThumbSession *s = g_thumbs.get();
+    if (!s) return G_SOURCE_REMOVE;
+    const bool finished = s->running.load() == 0;  // 先看线程是否都已退出，再取结果，不会漏掉最后一批
+    std::vector<size_t> ready;
+    {
+        std::lock_guard<std::mutex> lock(s->mutex);
+        ready.swap(s->ready);
+    }
+    for (size_t slot : ready) thumb_set_image(*s, slot);
+    if (finished) {
+        s->poll_id = 0;
+        return G_SOURCE_REMOVE;
+    }
+    return G_SOURCE_CONTINUE;
+}
+
+// 选帧窗口关闭：停下生成线程，把已有的缩略图写回旁路缓存
+static void thumb_session_end(GtkWidget *dialog, gpointer user_data) {
+    (void)dialog; (void)user_data;
+    if (!g_thumbs) return;
+    ThumbSession &s = *g_thumbs;
+    s.cancel.store(true);
+    for (std::thread &t : s.workers) t.join();
+    if (s.poll_id) g_source_remove(s.poll_id);
+    if (s.produced.load() > 0) {
+        std::vector<uint32_t> frames;
+        std::vector<const uint8_t *> pixels;
+        for (size_t i = 0; i < s.frames.size(); ++i) {
+            if (s.rgb[i].empty()) continue;
+            frames.push_back((uint32_t)s.frames[i]);
+            pixels.push_back(s.rgb[i].data());
+        }
+        if (thumb_cache_write(s.video_path.c_str(), TARGET_WIDTH, TARGET_HEIGHT, (uint32_t)frames.size(),
+                              frames.data(), pixels.data()) != 0) {
+            fprintf(stderr, "[缩略图] 无法写入缓存: %s%s\n", s.video_path.c_str(), THUMB_CACHE_SUFFIX);
         }
     }
-    if (td->dialog) gtk_widget_destroy(td->dialog);
-    free(td);
+    g_thumbs.reset();
 }
 
 static void open_tiled_selector_clicked(GtkWidget *widget, gpointer data)
 {
-    if (!g_cap.isOpened()) {
+    if (!playback_source_open()) {
         GtkWidget *err = gtk_message_dialog_new(GTK_WINDOW(window), GTK_DIALOG_DESTROY_WITH_PARENT,
-                                                GTK_MESSAGE_ERROR, GTK_BUTTONS_CLOSE, "请先导入视频");
+                                                GTK_MESSAGE_ERROR, GTK_BUTTONS_CLOSE, "请先导入视频或帧归档");
         gtk_dialog_run(GTK_DIALOG(err)); gtk_widget_destroy(err); return;
     }
     
     stop_playback(); // 停止播放
 
     // 获取总帧数与采样步长
-    int total = (int)g_cap.get(cv::CAP_PROP_FRAME_COUNT);
+    int total = playback_frame_count();
     if (total <= 0) total = 3000; // 某些容器不返回帧数
     const int maxThumbs = 200; // 限制最大缩略图数，避免内存与等待时间过大
     int step = total / maxThumbs; if (step < 1) step = 1;
@@ -887,31 +1580,62 @@ static void open_tiled_selector_clicked(GtkWidget *widget, gpointer data)
     gtk_grid_set_column_spacing(GTK_GRID(grid), 6);
     gtk_container_add(GTK_CONTAINER(scroll), grid);
 
-    // 生成缩略图
+    // 先摆好所有格子，缩略图随后填入
     const int cols = 6; // 每行几列
     int r = 0, c = 0;
-    double saved_pos = g_cap.get(cv::CAP_PROP_POS_FRAMES);
+    std::unique_ptr<ThumbSession> s(new ThumbSession());
     for (int i = 0; i < total; i += step) {
-        g_cap.set(cv::CAP_PROP_POS_FRAMES, i);
-        cv::Mat frame; if (!g_cap.read(frame)) break;
-        cv::Mat bgr = (frame.channels()==3) ? frame : (cv::Mat)cv::Mat();
-        if (frame.channels()!=3) cv::cvtColor(frame, bgr, cv::COLOR_GRAY2BGR);
-        cv::Mat rgb; cv::cvtColor(bgr, rgb, cv::COLOR_BGR2RGB);
-        cv::Mat thumb; cv::resize(rgb, thumb, cv::Size(TARGET_WIDTH, TARGET_HEIGHT), 0, 0, cv::INTER_AREA);
-        GdkPixbuf *pb = pixbuf_from_rgb_mat_copy(thumb);
-        if (!pb) continue;
-        GtkWidget *img = gtk_image_new_from_pixbuf(pb);
-        g_object_unref(pb);
+        GtkWidget *img = gtk_image_new();
+        gtk_widget_set_size_request(img, TARGET_WIDTH, TARGET_HEIGHT);
         GtkWidget *btn = gtk_button_new();
         gtk_container_add(GTK_CONTAINER(btn), img);
         ThumbData *td = (ThumbData*)malloc(sizeof(ThumbData));
         td->frame_index = i; td->dialog = dialog;
-        g_signal_connect(btn, "clicked", G_CALLBACK(on_thumb_clicked), td);
+        g_signal_connect_data(btn, "clicked", G_CALLBACK(on_thumb_clicked), td, (GClosureNotify)free, (GConnectFlags)0);
         gtk_grid_attach(GTK_GRID(grid), btn, c, r, 1, 1);
         if (++c >= cols) { c = 0; ++r; }
+        s->frames.push_back(i);
+        s->images.push_back(img);
+    }
+    s->rgb.resize(s->frames.size());
+
+    if (archive_active()) {
+        // 归档帧直接解包，无需解码
+        static uint8_t archive_thumb[IMAGE_H][IMAGE_W];
+        for (size_t k = 0; k < s->frames.size(); ++k) {
+            if (frame_archive_unpack_u8(&g_archive, (uint32_t)s->frames[k], &archive_thumb[0][0], IMAGE_W) != 0) break;
+            GdkPixbuf *pb = render_bw_array_pixbuf(archive_thumb, IMAGE_W, IMAGE_H, 1);
+            if (!pb) continue;
+            gtk_image_set_from_pixbuf(GTK_IMAGE(s->images[k]), pb);
+            g_object_unref(pb);
+        }
+    } else {
+        s->video_path = g_video_path;
+        thumb_cache cache;
+        const bool cached = thumb_cache_open(&cache, g_video_path.c_str(), TARGET_WIDTH, TARGET_HEIGHT) == 0;
+        for (size_t k = 0; k < s->frames.size(); ++k) {
+            const uint8_t *px = cached ? thumb_cache_find(&cache, (uint32_t)s->frames[k]) : NULL;
+            if (!px) {
+                s->pending.push_back(k);
+                continue;
+            }
+            s->rgb[k].assign(px, px + (size_t)TARGET_WIDTH * TARGET_HEIGHT * 3);
+            thumb_set_image(*s, k);
+        }
+        if (cached) thumb_cache_close(&cache);
+
+        if (!s->pending.empty()) {
+            int n = (int)std::thread::hardware_concurrency();
+            if (n < 1) n = 1;
+            if (n > THUMB_MAX_WORKERS) n = THUMB_MAX_WORKERS;
+            if (n > (int)s->pending.size()) n = (int)s->pending.size();
+            s->running.store(n);
+            for (int i = 0; i < n; ++i) s->workers.emplace_back(thumb_worker, s.get());
+            s->poll_id = g_timeout_add(THUMB_POLL_MS, thumb_poll, NULL);
+        }
     }
-    // 还原播放位置
-    g_cap.set(cv::CAP_PROP_POS_FRAMES, saved_pos);
+    g_thumbs = std::move(s);
+    g_signal_connect(dialog, "destroy", G_CALLBACK(thumb_session_end), NULL);
 
     gtk_widget_show_all(dialog);
     g_signal_connect_swapped(dialog, "response", G_CALLBACK(gtk_widget_destroy), dialog);
@@ -926,14 +1650,15 @@ static void open_video_clicked(GtkWidget *widget, gpointer data) {
         g_free(filename);
         if (!g_video_path.empty()) {
             stop_playback(); // 停止当前播放
+            frame_archive_close(&g_archive); // 视频代替归档作为帧源
+            g_archive_pos = -1;
             if (g_cap.isOpened()) g_cap.release();
-            g_cap.open(g_video_path);
+            g_cap.open(g_video_path, g_luma_decode);
+            g_frame_cache.clear();
+            g_cap_next = 0;
             g_frame_index = 0;
             if (g_cap.isOpened()) {
-                cv::Mat frame; 
-                if (g_cap.read(frame)) { 
-                    g_frame_index = 1; 
-                    show_cv_frame(frame);
+                if (show_video_frame(0)) {
                     update_progress_bar();
                 } else {
                     GtkWidget *err = gtk_message_dialog_new(GTK_WINDOW(window), GTK_DIALOG_DESTROY_WITH_PARENT,
@@ -951,27 +1676,76 @@ static void open_video_clicked(GtkWidget *widget, gpointer data) {
 }
 
 static void next_frame_clicked(GtkWidget *widget, gpointer data) {
-    if (!g_cap.isOpened()) return;
+    if (!playback_source_open()) return;
     stop_playback(); // 停止播放
-    cv::Mat frame; 
-    if (g_cap.read(frame)) { 
-        ++g_frame_index; 
-        show_cv_frame(frame);
-        update_progress_bar();
-    }
+    if (playback_next()) update_progress_bar();
 }
 
 static void prev_frame_clicked(GtkWidget *widget, gpointer data) {
-    if (!g_cap.isOpened()) return;
+    if (!playback_source_open()) return;
     stop_playback(); // 停止播放
-    double pos = g_cap.get(cv::CAP_PROP_POS_FRAMES);
-    double back = pos - 2; if (back < 0) back = 0;
-    g_cap.set(cv::CAP_PROP_POS_FRAMES, back);
-    cv::Mat frame; if (g_cap.read(frame)) { 
-        g_frame_index = (int)g_cap.get(cv::CAP_PROP_POS_FRAMES); 
-        show_cv_frame(frame);
-        update_progress_bar();
-    }
+    int back = archive_active() ? g_archive_pos - 1 : g_frame_index - 2;
+    if (back < 0) back = 0;
+    if (playback_seek(back)) update_progress_bar();
+}
+
+// ---------------- 播放调度 ----------------
+// - 开播时记下 t0，第 k 帧（从开播起数，含丢掉的帧）的显示时刻为 t0 + (k+1)·间隔；定时器每次按
+//   距下一个显示时刻的剩余时间重新设定，处理耗时不会累加到间隔上，长时间播放也不漂移
+// - 允许丢帧时，来不及显示的帧只前进不处理：预取模式由预取线程跳过，否则在定时器里直接跳到
+//   该显示的帧；不允许丢帧时落后多少就把 t0 顺延多少，播放变慢但逐帧显示
+// - 进度条旁显示实际帧率（每 0.5 秒更新）、丢帧数与最大延迟，停播后保留最后一次的统计
+static const int PLAYBACK_POLL_MS = 2;    // 预取结果未就绪时的轮询间隔
+static const std::chrono::milliseconds PLAYBACK_STATUS_PERIOD(500);
+
+static std::chrono::steady_clock::time_point playback_deadline(long long seq) {
+    return g_clock.t0 + g_clock.interval * (seq + 1);
+}
+
+static void playback_clock_start() {
+    g_clock = PlaybackClock();
+    g_clock.interval = std::chrono::microseconds((long long)(1e6 / (playback_fps() * g_playback_speed)));
+    if (g_clock.interval.count() < 1000) g_clock.interval = std::chrono::microseconds(1000);
+    g_clock.t0 = std::chrono::steady_clock::now();
+    g_clock.stat_t0 = g_clock.t0;
+    if (g_playback_status) gtk_label_set_text(GTK_LABEL(g_playback_status), "");
+}
+
+// 在 when 时刻触发下一次定时器（毫秒精度，向上取整；至少 1ms）
+static void playback_schedule_at(std::chrono::steady_clock::time_point when) {
+    const auto wait = std::chrono::duration_cast<std::chrono::microseconds>(when - std::chrono::steady_clock::now());
+    const long long ms = wait.count() > 0 ? (wait.count() + 999) / 1000 : 1;
+    g_playback_timer = g_timeout_add((guint)ms, playback_timer_callback, NULL);
+}
+
+// 跳过 n 帧不处理（至少留下最后一帧给 playback_next 显示），返回实际跳过的帧数
+static int playback_skip(int n) {
+    const int total = playback_frame_count();
+    const int next = playback_position();  // 下一帧的位置（从 0 开始）
+    if (total > 0 && n > total - 1 - next) n = std::max(0, total - 1 - next);
+    if (archive_active()) g_archive_pos += n;
+    else g_frame_index += n;
+    return n;
+}
+
+// 第 seq 帧已显示：记延迟、顺延时钟（不允许丢帧时）、更新状态栏
+static void playback_frame_shown(long long seq, std::chrono::steady_clock::time_point deadline) {
+    const auto now = std::chrono::steady_clock::now();
+    const long long late_us = std::chrono::duration_cast<std::chrono::microseconds>(now - deadline).count();
+    if (late_us > g_clock.max_late_us) g_clock.max_late_us = late_us;
+    if (!g_allow_drop && late_us > 0) g_clock.t0 += std::chrono::microseconds(late_us);
+    g_clock.seq = seq + 1;
+    ++g_clock.stat_frames;
+
+    const auto span = now - g_clock.stat_t0;
+    if (span < PLAYBACK_STATUS_PERIOD || !g_playback_status) return;
+    g_clock.fps = g_clock.stat_frames / std::chrono::duration<double>(span).count();
+    g_clock.stat_t0 = now;
+    g_clock.stat_frames = 0;
+    char text[96];
+    snprintf(text, sizeof(text), "实际 %.1f fps  丢帧 %d  最大延迟 %.1f ms",
+             g_clock.fps, g_clock.dropped, g_clock.max_late_us / 1000.0);
+    gtk_label_set_text(GTK_LABEL(g_playback_status), text);
 }
 
 // 播放控制函数
@@ -980,6 +1754,9 @@ static void stop_playback() {
         g_source_remove(g_playback_timer);
         g_playback_timer = 0;
     }
+#if PLAYBACK_PREFETCH
+    prefetch_stop();
+#endif
     g_is_playing = FALSE;
     if (g_play_button) {
         gtk_button_set_label(GTK_BUTTON(g_play_button), "▶ 播放");
@@ -987,13 +1764,7 @@ static void stop_playback() {
 }
 
 static void start_playback() {
-    if (!g_cap.isOpened()) return;
-    
-    // 计算定时器间隔（毫秒）
-    double fps = g_cap.get(cv::CAP_PROP_FPS);
-    if (fps <= 0) fps = 25.0; // 默认25fps
-    int interval_ms = (int)(1000.0 / (fps * g_playback_speed));
-    if (interval_ms < 1) interval_ms = 1; // 至少1ms
+    if (!playback_source_open()) return;
     
     g_is_playing = TRUE;
     if (g_play_button) {
@@ -1004,49 +1775,84 @@ static void start_playback() {
     if (g_playback_timer != 0) {
         g_source_remove(g_playback_timer);
     }
-    g_playback_timer = g_timeout_add(interval_ms, playback_timer_callback, NULL);
+    playback_clock_start();
+#if PLAYBACK_PREFETCH
+    prefetch_start();
+#endif
+    playback_schedule_at(playback_deadline(g_clock.seq));
 }
 
 static gboolean playback_timer_callback(gpointer user_data) {
-    if (!g_is_playing || !g_cap.isOpened()) {
+    (void)user_data;
+    g_playback_timer = 0;  // 每次回调都返回 G_SOURCE_REMOVE，按下一帧的显示时刻重新设定
+    if (!g_is_playing || !playback_source_open()) {
         stop_playback();
         return G_SOURCE_REMOVE;
     }
-    
-    // 读取下一帧
-    cv::Mat frame;
-    if (g_cap.read(frame)) {
-        ++g_frame_index;
-        show_cv_frame(frame);
+    const auto now = std::chrono::steady_clock::now();
+
+    // 换上下一帧（预取模式下只是取出后台已处理好的结果；还没好就稍后再看）
+#if PLAYBACK_PREFETCH
+    bool ended = false;
+    const PrefetchedFrame *f = prefetch_peek(&ended);
+    if (!f) {
+        if (ended) stop_playback();
+        else playback_schedule_at(now + std::chrono::milliseconds(PLAYBACK_POLL_MS));
+        return G_SOURCE_REMOVE;
+    }
+    const long long seq = f->seq;
+    const auto deadline = playback_deadline(seq);
+    if (now < deadline) {
+        playback_schedule_at(deadline);
+        return G_SOURCE_REMOVE;
+    }
+    prefetch_show_due();
+    g_clock.dropped = g_prefetch->dropped.load(std::memory_order_relaxed);
+    const bool shown = true;
+#else
+    long long seq = g_clock.seq;
+    auto deadline = playback_deadline(seq);
+    if (now < deadline) {
+        playback_schedule_at(deadline);
+        return G_SOURCE_REMOVE;
+    }
+    if (g_allow_drop) {
+        const long long behind = (now - deadline) / g_clock.interval;
+        if (behind > 0) {
+            const int skipped = playback_skip(behind > INT_MAX ? INT_MAX : (int)behind);
+            g_clock.dropped += skipped;
+            seq += skipped;
+            deadline = playback_deadline(seq);
+        }
+    }
+    const bool shown = playback_next();
+    const bool ended = !shown;
+#endif
+    if (shown) {
+        playback_frame_shown(seq, deadline);
         update_progress_bar();
         
         // 检查是否到达视频末尾
-        int total_frames = (int)g_cap.get(cv::CAP_PROP_FRAME_COUNT);
-        if (total_frames > 0 && g_frame_index >= total_frames) {
+        int total_frames = playback_frame_count();
+        if (total_frames > 0 && playback_position() >= total_frames) {
             stop_playback();
             return G_SOURCE_REMOVE;
         }
-        
-        // 根据倍速调整定时器间隔
-        double fps = g_cap.get(cv::CAP_PROP_FPS);
-        if (fps <= 0) fps = 25.0;
-        int interval_ms = (int)(1000.0 / (fps * g_playback_speed));
-        if (interval_ms < 1) interval_ms = 1;
-        
-        // 移除旧定时器并创建新的（以应用新的倍速）
-        g_playback_timer = g_timeout_add(interval_ms, playback_timer_callback, NULL);
-        return G_SOURCE_REMOVE;
-    } else {
+    }
+    if (ended) {
         // 到达视频末尾
         stop_playback();
         return G_SOURCE_REMOVE;
     }
+    
+    playback_schedule_at(playback_deadline(g_clock.seq));
+    return G_SOURCE_REMOVE;
 }
 
 static void play_pause_clicked(GtkWidget *widget, gpointer data) {
-    if (!g_cap.isOpened()) {
+    if (!playback_source_open()) {
         GtkWidget *err = gtk_message_dialog_new(GTK_WINDOW(window), GTK_DIALOG_DESTROY_WITH_PARENT,
-                                                GTK_MESSAGE_ERROR, GTK_BUTTONS_CLOSE, "请先导入视频");
+                                                GTK_MESSAGE_ERROR, GTK_BUTTONS_CLOSE, "请先导入视频或帧归档");
         gtk_dialog_run(GTK_DIALOG(err));
         gtk_widget_destroy(err);
         return;
@@ -1059,6 +1865,33 @@ static void play_pause_clicked(GtkWidget *widget, gpointer data) {
     }
 }
 
+// 切换解码方式：按新方式重新打开视频并停在当前帧
+static void luma_decode_toggled(GtkToggleButton *button, gpointer data) {
+    g_luma_decode = gtk_toggle_button_get_active(button);
+    if (!g_cap.isOpened() || g_video_path.empty()) return;
+    stop_playback();
+    const int current = g_frame_index;
+    g_frame_cache.clear(); // 缓存的是旧解码方式的帧
+    g_cap_next = 0;
+    if (!g_cap.open(g_video_path, g_luma_decode)) {
+        g_frame_index = 0;
+        return;
+    }
+    if (show_video_frame(current > 0 ? current - 1 : 0)) {
+        update_progress_bar();
+    }
+}
+
+// 切换是否允许丢帧；正在播放时按新设置重新开播
+static void allow_drop_toggled(GtkToggleButton *button, gpointer data) {
+    (void)data;
+    g_allow_drop = gtk_toggle_button_get_active(button);
+    if (g_is_playing) {
+        stop_playback();
+        start_playback();
+    }
+}
+
 static void speed_changed(GtkWidget *widget, gpointer data) {
     GtkComboBox *combo = GTK_COMBO_BOX(widget);
     int active = gtk_combo_box_get_active(combo);
@@ -1083,12 +1916,12 @@ static void speed_changed(GtkWidget *widget, gpointer data) {
 }
 
 static void update_progress_bar() {
-    if (!g_cap.isOpened() || !g_progress_scale) return;
+    if (!playback_source_open() || !g_progress_scale) return;
     
-    int total_frames = (int)g_cap.get(cv::CAP_PROP_FRAME_COUNT);
+    int total_frames = playback_frame_count();
     if (total_frames <= 0) return;
     
-    double progress = (double)g_frame_index / total_frames * 100.0;
+    double progress = (double)playback_position() / total_frames * 100.0;
     
     g_updating_progress = TRUE;
     gtk_range_set_value(GTK_RANGE(g_progress_scale), progress);
@@ -1096,10 +1929,10 @@ static void update_progress_bar() {
 }
 
 static void progress_scale_changed(GtkRange *range, gpointer user_data) {
-    if (g_updating_progress || !g_cap.isOpened()) return;
+    if (g_updating_progress || !playback_source_open()) return;
     
     double value = gtk_range_get_value(range);
-    int total_frames = (int)g_cap.get(cv::CAP_PROP_FRAME_COUNT);
+    int total_frames = playback_frame_count();
     if (total_frames <= 0) return;
     
     int target_frame = (int)(value / 100.0 * total_frames);
@@ -1110,12 +1943,7 @@ static void progress_scale_changed(GtkRange *range, gpointer user_data) {
     gboolean was_playing = g_is_playing;
     stop_playback();
     
-    g_cap.set(cv::CAP_PROP_POS_FRAMES, target_frame);
-    cv::Mat frame;
-    if (g_cap.read(frame)) {
-        g_frame_index = (int)g_cap.get(cv::CAP_PROP_POS_FRAMES);
-        show_cv_frame(frame);
-    }
+    playback_seek(target_frame);
     
     // 如果之前在播放，继续播放
     if (was_playing) {
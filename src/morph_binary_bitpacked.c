@@ -281,9 +281,9 @@ void precise_edge_detection_bitpacked(const uint32_t* RESTRICT src_bits,
 #define IMG_HEIGHT 120
 #define NUM_WORDS (((IMG_WIDTH + 31) >> 5) * IMG_HEIGHT)
 
-static uint32_t s_buf1[NUM_WORDS];
-static uint32_t s_buf2[NUM_WORDS];
-static uint32_t s_buf3[NUM_WORDS];
+static PIPELINE_TLS uint32_t s_buf1[NUM_WORDS];
+static PIPELINE_TLS uint32_t s_buf2[NUM_WORDS];
+static PIPELINE_TLS uint32_t s_buf3[NUM_WORDS];
 
 // 适配器：对 u16 二值图进行形态学清洗（开运算+闭运算）
 void morph_clean_u16_binary_adapter(const uint16_t* RESTRICT src_u16,
@@ -0,0 +1,58 @@
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 199309L  /* clock_gettime */
+#endif
+#include "pipeline_timing.h"
+
+#ifdef PIPELINE_PROFILE
+PIPELINE_TLS pipeline_stage_times pipeline_frame_stages;
+
+#if defined(_WIN32)
+#include <windows.h>
+uint64_t pipeline_now_ns(void)
+{
+    static LARGE_INTEGER freq;
+    LARGE_INTEGER now;
+    if (freq.QuadPart == 0) QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&now);
+    return (uint64_t)((double)now.QuadPart * 1e9 / (double)freq.QuadPart);
+}
+#else
+#include <time.h>
+uint64_t pipeline_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+#endif
+#endif
+
+void pipeline_counter_add(pipeline_counter *c, uint64_t ns)
+{
+    c->calls++;
+    c->total_ns += ns;
+    if (ns > c->max_ns) c->max_ns = ns;
+}
+
+void pipeline_counter_reset(pipeline_counter *c)
+{
+    c->calls = 0;
+    c->total_ns = 0;
+    c->max_ns = 0;
+}
+
+const char *pipeline_stage_name(int stage)
+{
+    static const char *const names[PIPELINE_STAGE_COUNT] = {
+        "element_dispatch",
+        "morph_clean",
+        "start_point",
+        "search_l_r",
+        "get_left/right",
+        "cross_fill",
+        "left_ring_linefix",
+        "draw_edge",
+        "userlog",
+    };
+    return (stage >= 0 && stage < PIPELINE_STAGE_COUNT) ? names[stage] : "?";
+}
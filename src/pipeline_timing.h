@@ -0,0 +1,86 @@
+#ifndef PIPELINE_TIMING_H
+#define PIPELINE_TIMING_H
+
+/*
+  流水线计时（桌面调试用）
+
+  设计说明：
+  - 定义 PIPELINE_PROFILE 时使用单调时钟计时（纳秒）；未定义时 pipeline_now_ns() 恒为 0，
+    计时代码在单片机上被编译器整体消掉，只保留计数。
+  - pipeline_counter 只做“次数 / 总耗时 / 最大耗时”三项累加，不做任何分配。
+  - 分阶段计时：process_original_to_imo / image_process 在各阶段之间打点，把本帧各阶段耗时记进
+    线程局部的 pipeline_stage_times；未定义 PIPELINE_PROFILE 时打点宏为空，单片机上不留任何代码和变量。
+*/
+
+#include <stdint.h>
+#include "pipeline_tls.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    uint32_t calls;      /* 累计调用次数 */
+    uint64_t total_ns;   /* 累计耗时 */
+    uint64_t max_ns;     /* 单次最大耗时 */
+} pipeline_counter;
+
+#ifdef PIPELINE_PROFILE
+/* 单调时钟，单位纳秒 */
+uint64_t pipeline_now_ns(void);
+#else
+#define pipeline_now_ns() ((uint64_t)0)
+#endif
+
+/* 记录一次耗时 */
+void pipeline_counter_add(pipeline_counter *c, uint64_t ns);
+
+/* 清零 */
+void pipeline_counter_reset(pipeline_counter *c);
+
+/* 单帧流水线阶段（按执行顺序） */
+typedef enum {
+    PIPELINE_STAGE_ELEMENT = 0,     /* element_dispatch */
+    PIPELINE_STAGE_MORPH,           /* 形态学滤波 + 填黑框 */
+    PIPELINE_STAGE_START_POINT,     /* get_start_point */
+    PIPELINE_STAGE_SEARCH,          /* search_l_r 八邻域 */
+    PIPELINE_STAGE_GET_BORDER,      /* get_left + get_right */
+    PIPELINE_STAGE_CROSS_FILL,      /* cross_fill */
+    PIPELINE_STAGE_RING_LINEFIX,    /* left_ring_linefix */
+    PIPELINE_STAGE_DRAW_EDGE,       /* 中线 + draw_edge */
+    PIPELINE_STAGE_USERLOG,         /* userlog */
+    PIPELINE_STAGE_COUNT
+} pipeline_stage;
+
+typedef struct {
+    uint64_t ns[PIPELINE_STAGE_COUNT];
+} pipeline_stage_times;
+
+/* 阶段名（即对应的函数名）；越界返回 "?" */
+const char *pipeline_stage_name(int stage);
+
+#ifdef PIPELINE_PROFILE
+/* 当前线程最近一帧的分阶段耗时 */
+extern PIPELINE_TLS pipeline_stage_times pipeline_frame_stages;
+
+/* 在一帧开始时清零，之后每个 PIPELINE_STAGE_MARK 把距上一次打点的耗时记到该阶段 */
+#define PIPELINE_STAGE_RESET() \
+    do { for (int stage_i_ = 0; stage_i_ < PIPELINE_STAGE_COUNT; stage_i_++) pipeline_frame_stages.ns[stage_i_] = 0; } while (0)
+#define PIPELINE_STAGE_BEGIN() uint64_t pipeline_stage_t_ = pipeline_now_ns()
+#define PIPELINE_STAGE_MARK(stage) \
+    do { \
+        const uint64_t stage_now_ = pipeline_now_ns(); \
+        pipeline_frame_stages.ns[stage] += stage_now_ - pipeline_stage_t_; \
+        pipeline_stage_t_ = stage_now_; \
+    } while (0)
+#else
+#define PIPELINE_STAGE_RESET() ((void)0)
+#define PIPELINE_STAGE_BEGIN() ((void)0)
+#define PIPELINE_STAGE_MARK(stage) ((void)0)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PIPELINE_TIMING_H */
@@ -0,0 +1,25 @@
+#ifndef PIPELINE_TLS_H
+#define PIPELINE_TLS_H
+
+/*
+  流水线全局状态的线程局部存储开关
+
+  - 算法在单片机上以全局变量保存帧间状态（watch、边线、imo 等），只有一条流水线。
+  - 桌面批处理要在同一进程里并行跑多段视频：定义 PIPELINE_THREAD_LOCAL 后，这些全局变量
+    （定义和 extern 声明都加 PIPELINE_TLS）变为每线程一份，每个线程就是一条独立的流水线。
+  - 未定义时 PIPELINE_TLS 为空，单片机代码与内存布局不变。
+  - 用 __thread / __declspec(thread) 而不是 C++ thread_local：变量都是 POD，C 与 C++ 两侧
+    访问方式一致，不引入 C++ 的 TLS 包装函数。
+*/
+
+#if defined(PIPELINE_THREAD_LOCAL)
+  #if defined(_MSC_VER)
+    #define PIPELINE_TLS __declspec(thread)
+  #else
+    #define PIPELINE_TLS __thread
+  #endif
+#else
+  #define PIPELINE_TLS
+#endif
+
+#endif /* PIPELINE_TLS_H */
@@ -0,0 +1,82 @@
+#ifndef PIXBUF_POOL_H
+#define PIXBUF_POOL_H
+
+#include <gtk/gtk.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+// 按尺寸复用的 RGB pixbuf 池（可多线程使用）
+// - acquire 的用法与 gdk_pixbuf_new 相同：返回的 pixbuf 调用者持有一个引用，用完 g_object_unref
+// - 池对每个 pixbuf 自己留一个引用；引用计数回到 1 说明 GtkImage、预取队列等都已放手，可以再发出去。
+//   视图尺寸不变时每个视图在几个 pixbuf 之间轮换，不再逐帧分配；尺寸一变就分配新尺寸的
+// - 新分配时顺带把空闲的 pixbuf 削减到 max_idle 个以内（先放最久未用的，旧尺寸的自然被淘汰）
+// - 发出去的 pixbuf 里是上一次的内容，调用者必须整幅重写
+class PixbufPool {
+public:
+    explicit PixbufPool(std::size_t max_idle) : max_idle_(max_idle) {}
+
+    ~PixbufPool() {
+        for (Entry &e : entries_) g_object_unref(e.pb);
+    }
+
+    PixbufPool(const PixbufPool &) = delete;
+    PixbufPool &operator=(const PixbufPool &) = delete;
+
+    GdkPixbuf *acquire(int w, int h) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (Entry &e : entries_) {
+            if (e.w == w && e.h == h && idle(e)) {
+                e.stamp = ++clock_;
+                g_object_ref(e.pb);
+                return e.pb;
+            }
+        }
+        GdkPixbuf *pb = gdk_pixbuf_new(GDK_COLORSPACE_RGB, FALSE, 8, w, h);
+        if (!pb) return NULL;
+        allocations_.fetch_add(1, std::memory_order_relaxed);
+        trim();
+        entries_.push_back(Entry{pb, w, h, ++clock_});
+        g_object_ref(pb);
+        return pb;
+    }
+
+    // 累计新分配次数
+    std::size_t allocations() const { return allocations_.load(std::memory_order_relaxed); }
+
+private:
+    struct Entry {
+        GdkPixbuf *pb;
+        int w, h;
+        uint64_t stamp;  // 最近一次发出的序号
+    };
+
+    // 只剩池自己的引用；此时别处拿不到它，不会在判断之后又被引用
+    static bool idle(const Entry &e) {
+        return g_atomic_int_get(&G_OBJECT(e.pb)->ref_count) == 1;
+    }
+
+    void trim() {
+        for (;;) {
+            std::size_t idle_count = 0, oldest = entries_.size();
+            for (std::size_t i = 0; i < entries_.size(); ++i) {
+                if (!idle(entries_[i])) continue;
+                ++idle_count;
+                if (oldest == entries_.size() || entries_[i].stamp < entries_[oldest].stamp) oldest = i;
+            }
+            if (idle_count <= max_idle_) return;
+            g_object_unref(entries_[oldest].pb);
+            entries_.erase(entries_.begin() + (std::ptrdiff_t)oldest);
+        }
+    }
+
+    std::mutex mutex_;
+    std::vector<Entry> entries_;
+    std::size_t max_idle_;
+    uint64_t clock_ = 0;
+    std::atomic<std::size_t> allocations_{0};
+};
+
+#endif // PIXBUF_POOL_H
@@ -4,6 +4,9 @@
 #include <stddef.h>
 #include "image.h"
 #include "dynamic_log.h"
+#include "fixed_point.h"
+#include "pipeline_timing.h"
+#include "ring_view.h"
 #ifdef PROCESSOR_VERIFY_BINARY
 #include <assert.h>
 #endif
@@ -22,7 +25,7 @@
 #define loop_forward_near 20
 #define forward_near 1 //我的数据
 //声明  
-void left_ring_confirm();
+void left_ring_confirm(const ring_view *v);
 
 //求绝对值
 int abs(int value)
@@ -31,10 +34,10 @@ int abs(int value)
     else return -value;
 }
 
-/*函数名称：void find_angle_left_down(int*angle_x,int*angle_y)
-功能说明：抓住左上第二角点
+/*函数名称：void find_angle_left_down(const ring_view *v,int*angle_x,int*angle_y)
+功能说明：抓住左上第二角点（angle_x 为视图列）
 */
-void find_angle_left_down(int*angle_x,int*angle_y)
+void find_angle_left_down(const ring_view *v,int*angle_x,int*angle_y)
 {
     /*
     //生长方向
@@ -82,7 +85,7 @@ void find_angle_left_down(int*angle_x,int*angle_y)
     while (y < y_top_limit) {
         int row = H - 1 - y;                 // 行索引转换：自下而上到自上而下
         if (row < 0 || row >= H) break;      // 保护
-        if (Grayscale[row][x] == 0) break;   // 命中黑点
+        if (rv_gray(v, row, x) == 0) break;   // 命中黑点
         y++;
     }
 
@@ -90,7 +93,7 @@ void find_angle_left_down(int*angle_x,int*angle_y)
     while (x + 1 < W) {
         int row = H - 1 - y;
         if (row < 0 || row >= H) break;
-        if (Grayscale[row][x + 1] == 255) break; // 右邻为白则停
+        if (rv_gray(v, row, x + 1) == 255) break; // 右邻为白则停
         x++;
     }
 
@@ -101,19 +104,19 @@ void find_angle_left_down(int*angle_x,int*angle_y)
         int row = H - 1 - y;
         if (row < 0 || row >= H) break;
 
-        if (Grayscale[row][x] == 0) {
+        if (rv_gray(v, row, x) == 0) {
             // 命中，保持 x 不变
-        } else if (x - 1 >= 0 && Grayscale[row][x - 1] == 0) {
+        } else if (x - 1 >= 0 && rv_gray(v, row, x - 1) == 0) {
             x -= 1;
-        } else if (x + 1 < W && Grayscale[row][x + 1] == 0) {
+        } else if (x + 1 < W && rv_gray(v, row, x + 1) == 0) {
             x += 1;
-        } else if (x - 2 >= 0 && Grayscale[row][x - 2] == 0) {
+        } else if (x - 2 >= 0 && rv_gray(v, row, x - 2) == 0) {
             x -= 2;
-        } else if (x + 2 < W && Grayscale[row][x + 2] == 0) {
+        } else if (x + 2 < W && rv_gray(v, row, x + 2) == 0) {
             x += 2;
-        } else if (x - 3 >= 0 && Grayscale[row][x - 3] == 0) {
+        } else if (x - 3 >= 0 && rv_gray(v, row, x - 3) == 0) {
             x -= 3;
-        } else if (x + 3 < W && Grayscale[row][x + 3] == 0) {
+        } else if (x + 3 < W && rv_gray(v, row, x + 3) == 0) {
             x += 3;
         } else {
             break; // 本行附近未找到黑点，结束
@@ -131,38 +134,26 @@ void find_angle_left_down(int*angle_x,int*angle_y)
 /*函数名称：void left_ring_first_angle()
 功能说明：左环第一角点
 */
-void left_ring_first_angle()
+void left_ring_first_angle(const ring_view *v)
 {
-for(int y=loop_forward_near;y<loop_forward_far;y++)//逐行扫描
+    // 候选行：左线 [y-2, y] 与右线 [y-5, y+5] 均未丢线（移位取窗口，代替逐行布尔链）
+    const lost_bits cand = lost_bits_and(lost_bits_clear_rows(v->l_lost, -2, 0),
+                                         lost_bits_clear_rows(v->r_lost, -5, 5));
+for(int y=lost_bits_next(&cand, loop_forward_near);y>=0&&y<loop_forward_far;y=lost_bits_next(&cand, y+1))//逐候选行扫描
     {
         if(
             //lineinfo[y + 3].left_lost
             //&&lineinfo[y + 2].left_lost&&
-            ((left_lost[y + 1])||((l_border[y]-l_border[y+1])>=5*(l_border[y+1]-l_border[y+2])))///////////
-            //&& !left_lost[y - 3]
-            && !left_lost[y - 2]
-            && !left_lost[y - 1]
-            && !left_lost[y]
-            && !right_lost[y + 5]
-            && !right_lost[y + 4]
-            && !right_lost[y + 3]
-            && !right_lost[y + 2]
-            && !right_lost[y + 1]
-            && !right_lost[y]
-            && !right_lost[y - 1]
-            && !right_lost[y - 2]
-            && !right_lost[y - 3]
-            && !right_lost[y - 4]
-            && !right_lost[y - 5]
+            ((lost_bits_test(v->l_lost, y + 1))||((rv_l(v,y)-rv_l(v,y+1))>=5*(rv_l(v,y+1)-rv_l(v,y+2))))///////////
 
-            && l_border[y] - l_border[y + 4] > 10
-            && y < watch.InLoopAngleL
+            && rv_l(v,y) - rv_l(v,y + 4) > 10
+            && y < *v->angle
             //&&lineinfo[y].left>=lineinfo[y-2].left
             && y < 75
             )
         {//左圆环的第一个角点所在行
-            watch.InLoopAngleL = y;
-            left_ring_confirm();//10.25testtag
+            *v->angle = y;
+            left_ring_confirm(v);//10.25testtag
             if(0)     //在当前无元素时进行以下操作，其他时候只找角点
             {
                    //left_ring_confirm();
@@ -175,14 +166,14 @@ for(int y=loop_forward_near;y<loop_forward_far;y++)//逐行扫描
 /*函数名称：void right_ring_first_angle()
 左环二次确认函数
 */
-void left_ring_confirm()
+void left_ring_confirm(const ring_view *v)
 {
     uint8_t zebra_confirm=0,white_count1=0,white_count2=0,white_count3=0,black_count=0,right_lost=0;
     //right_ring_first_angle();//扫描是否存在右环角点
     //left_ring_circular_arc();//扫描是否存在左环上弧
     for(int y=loop_forward_near;y<95;y++)//逐行扫描
     {
-        if(((r_border[y+2]-r_border[y])>2)||(r_border[y]-r_border[y+2])>4)
+        if(((rv_r(v,y+2)-rv_r(v,y))>2)||(rv_r(v,y)-rv_r(v,y+2))>4)
             right_lost+=1;
 //        if(lineinfo[y].right-lineinfo[y+2].right>20
 //           &&lineinfo[y-1].right-lineinfo[y+3].right>20
@@ -203,9 +194,9 @@ void left_ring_confirm()
            //vofa.loop[5]=white_count1;
            //vofa.loop[6]=white_count2;
            //vofa.loop[7]=white_count3;
-           for(int y=watch.InLoopAngleL;y>loop_forward_near;y--)
+           for(int y=*v->angle;y>loop_forward_near;y--)
            {
-               if(Grayscale[119-y][l_border[watch.InLoopAngleL]]==0)
+               if(rv_gray(v,119-y,rv_l(v,*v->angle))==0)
                   black_count++;
            }
 		   //老学长上位机
@@ -229,7 +220,7 @@ void left_ring_confirm()
                    set_speed(setpara.big_loop_speed);
                    //change_pid_para(&CAM_Turn,&setpara.big_loop_PID);
                }*/
-               watch.InLoop = 1;
+               rv_set_state(v,1);
                //beep2(1,20);//蜂鸣器
                return;
            }
@@ -242,28 +233,26 @@ void left_ring_confirm()
 /*函数名称：void left_ring_circular_arc()
 /*功能说明：左环上凸弧扫描函数
 */
-void left_ring_circular_arc()
+void left_ring_circular_arc(const ring_view *v)
 {
-    if (watch.InLoop != 1&&watch.InLoop != 2)return;//在循环之前跳出，节省时间
+    const uint8_t state = rv_state(v);
+    if (state != 1&&state != 2)return;//在循环之前跳出，节省时间
     //beep(20);
-    for(int y=loop_forward_near;y<loop_forward_far;y++)//逐行扫描
+    // 候选行：左线 [y-3, y+3] 均未丢线（第 y 行本身不参与，下面再按原条件判断边线形状）
+    lost_bits cand = lost_bits_and(lost_bits_clear_rows(v->l_lost, -3, -1),
+                                   lost_bits_clear_rows(v->l_lost, 1, 3));
+    for(int y=lost_bits_next(&cand, loop_forward_near);y>=0&&y<loop_forward_far;y=lost_bits_next(&cand, y+1))//逐候选行扫描
     {
         if (y <watch.InLoopAngle2  
-            &&(watch.InLoopAngleL<65)//去除了两个积分条件
+            &&(*v->angle<65)//去除了两个积分条件
            //&&(y>(watch.InLoopAngleL+20))
            &&y <watch.InLoopCirc   //初始化给120
-           &&!left_lost[y+3]
-           &&!left_lost[y+2]
-           &&!left_lost[y+1]
-           &&!left_lost[y-3]
-           &&!left_lost[y-2]
-           &&!left_lost[y-1]
-           &&l_border[y+1] <= l_border[y]
-           &&l_border[y+2] <= l_border[y]
-           &&l_border[y+3] <= l_border[y]
-           &&l_border[y-1] <= l_border[y]
-           &&l_border[y-2] <= l_border[y]
-           &&l_border[y-3] <= l_border[y]
+           &&rv_l(v,y+1) <= rv_l(v,y)
+           &&rv_l(v,y+2) <= rv_l(v,y)
+           &&rv_l(v,y+3) <= rv_l(v,y)
+           &&rv_l(v,y-1) <= rv_l(v,y)
+           &&rv_l(v,y-2) <= rv_l(v,y)
+           &&rv_l(v,y-3) <= rv_l(v,y)
            //&&(watch.right_lost+watch.cross_lost)<5
             )
        { //入环点所在行
@@ -276,9 +265,10 @@ void left_ring_circular_arc()
 /*函数名称：void left_ring_second_angle()
 功能说明：左环第二角点检测函数
 */
-void left_ring_second_angle()
+void left_ring_second_angle(const ring_view *v)
 {
-    if(watch.InLoop != 1&&watch.InLoop != 2)return;//在循环之前跳出，节省时间
+    const uint8_t state = rv_state(v);
+    if(state != 1&&state != 2)return;//在循环之前跳出，节省时间
     for(int y=loop_forward_far;y>loop_forward_near;y--)//逐行扫描
     {
         if (//watch.InLoopCirc<66&&
@@ -288,13 +278,13 @@ void left_ring_second_angle()
            &&y > 60
            &&y < (loop_forward_far-2)
            &&y>watch.InLoopCirc
-           &&l_border[y+1] > 30
-           &&(l_border[y+1]-l_border[y])<=2
-           &&(l_border[y]-l_border[y-4])>l_border[y]/2
+           &&rv_l(v,y+1) > 30
+           &&(rv_l(v,y+1)-rv_l(v,y))<=2
+           &&(rv_l(v,y)-rv_l(v,y-4))>rv_l(v,y)/2
            )
            {
                watch.InLoopAngle2 = y;
-               watch.InLoopAngle2_x=l_border[watch.InLoopAngle2];
+               watch.InLoopAngle2_x=rv_x(v,rv_l(v,watch.InLoopAngle2));//存实际列
                //if()
                //watch.InLoopCirc=0;
                break;
@@ -305,23 +295,25 @@ void left_ring_second_angle()
         &&watch.InLoopAngle2>50
         )
     {
-        find_angle_left_down(&watch.InLoopAngle2_x,&watch.InLoopAngle2);
+        int angle_x=rv_x(v,watch.InLoopAngle2_x);
+        find_angle_left_down(v,&angle_x,&watch.InLoopAngle2);
+        watch.InLoopAngle2_x=rv_x(v,angle_x);
     }
 }
 /*函数名称：void left_ring_begin_turn()
 功能说明：左环开始转向状态机函数
 */
-void left_ring_begin_turn()
+void left_ring_begin_turn(const ring_view *v)
 {
 	//去除了路径积分和角度积分
-    if(watch.InLoop!=1)return;//在循环之前跳出，节省时间
+    if(rv_state(v)!=1)return;//在循环之前跳出，节省时间
     if(/*get_integeral_state(&distance_integral)==2 路程积分完成
-        &&*/watch.InLoop==1
+        &&*/rv_state(v)==1
         &&watch.InLoopAngle2<=90  //注意，该值影响补线入环的早晚
     )
     {
         //clear_distant_integeral();//清除路程积分变量
-        watch.InLoop=2;
+        rv_set_state(v,2);
         //set_speed(setpara.loop_target_speed);
         //change_pid_para(&CAM_Turn,&setpara.loop_turn_PID);//将转向PID参数调为环内转向PID
         //watch.fix_slope=(float)(lineinfo[watch.InLoopAngle2].left)/(115-watch.InLoopAngle2);
@@ -332,40 +324,40 @@ void left_ring_begin_turn()
 /*函数名称：left_ring_prepare_out()
 功能说明：小车角度积分完成，准备出环
 */
-void left_ring_prepare_out()//第340帧
+void left_ring_prepare_out(const ring_view *v)//第340帧
 {
-    if(watch.InLoop != 3)return;
-    if( watch.InLoop == 3
+    if(rv_state(v) != 3)return;
+    if( rv_state(v) == 3
         //&&get_integeral_state(&angle_integral)==1 10.28 test tag
         //&&get_integeral_data(&angle_integral)>160
-        &&r_border[69]<120
-        &&r_border[69]>95
+        &&rv_r(v,69)<120
+        &&rv_r(v,69)>95
     )
    {
-       watch.InLoop = 4;
-       watch.OutLoop_turn_point_x=r_border[69];
+       rv_set_state(v,4);
+       watch.OutLoop_turn_point_x=v->r[69];//存实际列
        //beep2(4,20);
    }
 }
 /*函数名称：left_ring_out_angle()
 功能说明：检测出环时右角点位置
 */
-void left_ring_out_angle()
+void left_ring_out_angle(const ring_view *v)
 {
-    if(watch.InLoop != 4)return;//在循环之前跳出，节省时间
+    if(rv_state(v) != 4)return;//在循环之前跳出，节省时间
     for(int y = loop_forward_far;y>loop_forward_near;y--)//逐行扫描
         {
-        if ((watch.InLoop == 4)&&y<80
+        if ((rv_state(v) == 4)&&y<80
                  //lineinfo[y].left_lost
-                 &&r_border[y+1] >= r_border[y]
-                 &&r_border[y+2] >= r_border[y+1]
-                 &&r_border[y-1] >= r_border[y]
-                 &&r_border[y-2] >= r_border[y]
+                 &&rv_r(v,y+1) >= rv_r(v,y)
+                 &&rv_r(v,y+2) >= rv_r(v,y+1)
+                 &&rv_r(v,y-1) >= rv_r(v,y)
+                 &&rv_r(v,y-2) >= rv_r(v,y)
 /*                 &&lineinfo[y - 3].right > lineinfo[y - 1].right
                  &&lineinfo[y + 4].right > lineinfo[y + 2].right
                  &&lineinfo[y - 5].right > lineinfo[y - 3].right*/
-                 &&r_border[y] > 30
-                 &&Grayscale[119-y-2][r_border[y]]==255
+                 &&rv_r(v,y) > 30
+                 &&rv_gray(v,119-y-2,rv_r(v,y))==255
 )
              {
                  if(watch.OutLoopAngle1>y)
@@ -378,93 +370,218 @@ void left_ring_out_angle()
         }
 }
 /*----------------------------------补线---------------------------------------------------------------------*/
-float slopeL;
-float slopeOL;
-float slopeR;
-float slopeOR;
-float slopeJ;
-float slopeCL;
-float slopeCR;
+/*
+补线插值：x = trunc(x0 + (num/den) * n)
+原实现中的 slopeL/slopeR 等斜率都是两个整数之比，这里统一成“点斜式”求值，
+use_q16 为 1 时走 Q16.16 定点路径，为 0 时与原浮点表达式逐位一致（float 运算顺序相同）。
+den 为 0 时斜率按 0 处理（原浮点实现此时为 inf，转换结果未定义）。
+*/
+static inline int linefix_eval(int x0, int num, int den, int n, uint8_t use_q16)
+{
+    if (den == 0) return x0;
+    if (use_q16) return q16_affine_trunc(x0, q16_div_int(num, den), n);
+    return (int)((float)x0 + (float)num / (float)den * (float)n);
+}
+// 桌面多线程构建才允许按线程切换补线路径；单片机上仍是编译期常量，未选中的路径可被整体优化掉
+#if defined(PIPELINE_THREAD_LOCAL)
+PIPELINE_TLS uint8_t pipeline_linefix_q16 = IMAGE_USE_Q16;
+#define LINEFIX_USE_Q16 pipeline_linefix_q16
+#else
+#define LINEFIX_USE_Q16 IMAGE_USE_Q16
+#endif
 /*
 void left_ring_linefix()
-补线函数
+补线函数（作用于全局 l_border/r_border，右环状态下走镜像视图；算术路径由 IMAGE_FIXED_POINT 在编译期决定，
+定义 PIPELINE_THREAD_LOCAL 时可由 pipeline_linefix_q16 按线程改写）
 */
 void left_ring_linefix()
+{
+    const ring_view v = (watch.InLoop > RING_RIGHT_STATE_BASE) ? ring_view_right() : ring_view_left();
+    left_ring_linefix_view(&v, LINEFIX_USE_Q16);
+}
+/*
+void left_ring_linefix_on(uint8_t *lb, uint8_t *rb, uint8_t use_q16)
+对给定边线数组按左环补线，供定点/浮点比对工具直接调用两条路径
+*/
+void left_ring_linefix_on(uint8_t *lb, uint8_t *rb, uint8_t use_q16)
+{
+    const ring_view v = ring_view_make(lb, rb, &left_lost_bits, &right_lost_bits, 0);
+    left_ring_linefix_view(&v, use_q16);
+}
+/*
+void left_ring_linefix_view(const ring_view *v, uint8_t use_q16)
+补线主体：所有列坐标都在视图坐标系下计算，写回时再换算成实际列
+*/
+void left_ring_linefix_view(const ring_view *v, uint8_t use_q16)
 {
     uint16_t xl,xr;
+    const uint8_t state = rv_state(v);
+    int top_x = 0;
+    uint8_t top_valid = 0;//top_x 只依赖本帧不变的边线点，每帧求一次即可
     //vofa.loop[2]=watch.watch_lost;
     for (uint8_t y = forward_near; y <= 119; y++)//120原为赛道最远端
     {
-        xl = l_border[y];
-        xr = r_border[y];
-        if (watch.InLoop == 1 && watch.InLoopAngleL < watch.InLoopCirc
+        xl = rv_l(v,y);
+        xr = rv_r(v,y);
+        if (state == 1 && *v->angle < watch.InLoopCirc
               && watch.zebra_flag == 0
               && y < 81 && watch.InLoopAngle2 == 120)
            {// 先拉一道实现封住出口,由于左边丢线右边不丢线,故以右边为参考补左边线
-              slopeL=(float)(r_border[2]-r_border[80])/80;//x=k*y
-              watch.top_x=r_border[0]-118*slopeL;
-              slopeL=(float)(watch.top_x-l_border[0])/118;
-               xl = watch.top_x-slopeL*(118-y);
+              //slopeL=(r[2]-r[80])/80; top_x=r[0]-118*slopeL; slopeL=(top_x-l[0])/118
+              if (!top_valid) {
+                  top_x = linefix_eval(rv_r(v,0), rv_r(v,2)-rv_r(v,80), 80, -118, use_q16);
+                  watch.top_x = rv_x(v, top_x);//存实际列
+                  top_valid = 1;
+              }
+              xl = linefix_eval(top_x, top_x-rv_l(v,0), 118, y-118, use_q16);
            }
 
            // 开始入左环
            // 入环点为了解决从右边沿拉线导致，打角不稳问题
-          else if(watch.InLoop == 2)
+          else if(state == 2)
           {
               //slopeR=(float)(lineinfo[40].right-watch.InLoopAngle2_x)/(watch.InLoopAngle2-40);
-              slopeR=(float)watch.InLoopAngle2_x/(115-watch.InLoopAngle2);//115是左顶点纵坐标
-              xr=(uint16_t)(slopeR*(watch.InLoopAngle2-y)+watch.InLoopAngle2_x);
+              //slopeR=InLoopAngle2_x/(115-InLoopAngle2)，115是左顶点纵坐标
+              const int angle2_x = rv_x(v, watch.InLoopAngle2_x);
+              xr=(uint16_t)linefix_eval(angle2_x, angle2_x,
+                                        115-watch.InLoopAngle2, watch.InLoopAngle2-y, use_q16);
               if(xr>186)xr=186;
               if(y>watch.InLoopAngle2||watch.InLoopAngle2<70)xl=0;
           }
-          else if(watch.InLoop == 3)
+          else if(state == 3)
           {
               if(y>50)xl=0;
           }
            // 开始出左环
-           else if (watch.InLoop == 4 )
+           else if (state == 4 )
            {
                if(y>50)xl=0;
-               if(r_border[watch.OutLoopAngle1] > 60 && y > watch.OutLoopAngle1)
+               if(rv_r(v,watch.OutLoopAngle1) > 60 && y > watch.OutLoopAngle1)
                {
                // 一元一次方程,参考图片/出左环.png
-               xr=watch.OutLoop_turn_point_x+(69-y);
+               xr=rv_x(v,watch.OutLoop_turn_point_x)+(69-y);
                }
                //begin_angal_integeral(50);
            }
            // 出左环直行
-           else if (watch.InLoop == 5
+           else if (state == 5
                    &&watch.OutLoopAngle2==120
                    &&watch.zebra_flag == 0)
            {// 封住入环口,补线思路是从角点向下拉线到near右边沿减145的地方
                // xl = lineinfo[y].right - 132 + y;
-               slopeL=(float)(r_border[45]-r_border[75])/30;
-               watch.top_x=r_border[45]-73*slopeL;
-               slopeL=(float)(watch.top_x-20)/118;
-                xl = watch.top_x-slopeL*(118-y);
+               //slopeL=(r[45]-r[75])/30; top_x=r[45]-73*slopeL; slopeL=(top_x-20)/118
+               if (!top_valid) {
+                   top_x = linefix_eval(rv_r(v,45), rv_r(v,45)-rv_r(v,75), 30, -73, use_q16);
+                   watch.top_x = rv_x(v, top_x);//存实际列
+                   top_valid = 1;
+               }
+               xl = linefix_eval(top_x, top_x-20, 118, y-118, use_q16);
     //            slopeL=(lineinfo[watch.watch_lost].left-lineinfo[100].left)/(watch.watch_lost-100);
     //            xl = lineinfo[100].left+(y-100)*slopeL;
            }
-           else if (watch.InLoop == 5
+           else if (state == 5
                    &&watch.OutLoopAngle2!=120
                    &&y < watch.OutLoopAngle2
                    && watch.zebra_flag == 0)
            {// 封住入环口，基本跟上面一样，为了鲁棒大圆环
                // xl = lineinfo[y].right - 132 + y;
-               slopeL=(float)(r_border[20]-r_border[80])/60;
-               watch.top_x=r_border[20]-98*slopeL;
-               slopeL=(float)(watch.top_x-l_border[watch.OutLoopAngle2+1])/(117-watch.OutLoopAngle2);
-               xl=watch.top_x-slopeL*(118-y);
+               //slopeL=(r[20]-r[80])/60; top_x=r[20]-98*slopeL; slopeL=(top_x-l[OA2+1])/(117-OA2)
+               if (!top_valid) {
+                   top_x = linefix_eval(rv_r(v,20), rv_r(v,20)-rv_r(v,80), 60, -98, use_q16);
+                   watch.top_x = rv_x(v, top_x);//存实际列
+                   top_valid = 1;
+               }
+               xl = linefix_eval(top_x, top_x-rv_l(v,watch.OutLoopAngle2+1),
+                                 117-watch.OutLoopAngle2, y-118, use_q16);
     //            slopeL=(lineinfo[watch.watch_lost].left-lineinfo[100].left)/(watch.watch_lost-100);
     //            xl = lineinfo[100].left+(y-100)*slopeL;
            }
         //对补线后的结果进行逆透视变换
         //persp_task(xl,xr,y);
 
-        l_border[y]=xl;
-        r_border[y]=xr;
+        rv_set_l(v,y,xl);
+        rv_set_r(v,y,xr);
+    }
+}
+/*
+  元素检测调度表
+  - element_detectors 给出全局固定的执行顺序（与原先逐个调用的顺序一致）；
+  - element_state_plan[s] 列出视图状态为 s 时需要跑的检测函数（与各函数开头的状态判断一致）；
+  - 先在左环视图、再在镜像的右环视图上各跑一遍，右环复用同一套 left_ring_* 检测函数；
+  - 每跑完一个检测函数都重新读取状态，同一帧内的状态切换（如 3→4 后立刻找出环角点）保持原行为；
+  - 新增元素时只需登记函数并在对应状态的位图里加一位。
+*/
+typedef void (*element_detector_fn)(const ring_view *v);
+
+enum {
+    DET_FIRST_ANGLE,
+    DET_CIRCULAR_ARC,
+    DET_SECOND_ANGLE,
+    DET_BEGIN_TURN,
+    DET_PREPARE_OUT,
+    DET_OUT_ANGLE,
+    DET_COUNT
+};
+#define DET_BIT(d) ((uint16_t)(1u << (d)))
+
+static const element_detector_fn element_detectors[DET_COUNT] = {
+    [DET_FIRST_ANGLE]  = left_ring_first_angle,
+    [DET_CIRCULAR_ARC] = left_ring_circular_arc,
+    [DET_SECOND_ANGLE] = left_ring_second_angle,
+    [DET_BEGIN_TURN]   = left_ring_begin_turn,
+    [DET_PREPARE_OUT]  = left_ring_prepare_out,
+    [DET_OUT_ANGLE]    = left_ring_out_angle,
+};
+
+// 第一角点没有状态判断，任何状态下都在找角点
+static const uint16_t element_state_plan[RING_STATE_COUNT] = {
+    [0] = DET_BIT(DET_FIRST_ANGLE),
+    [1] = DET_BIT(DET_FIRST_ANGLE) | DET_BIT(DET_CIRCULAR_ARC) | DET_BIT(DET_SECOND_ANGLE) | DET_BIT(DET_BEGIN_TURN),
+    [2] = DET_BIT(DET_FIRST_ANGLE) | DET_BIT(DET_CIRCULAR_ARC) | DET_BIT(DET_SECOND_ANGLE),
+    [3] = DET_BIT(DET_FIRST_ANGLE) | DET_BIT(DET_PREPARE_OUT),
+    [4] = DET_BIT(DET_FIRST_ANGLE) | DET_BIT(DET_OUT_ANGLE),
+    [5] = DET_BIT(DET_FIRST_ANGLE),
+};
+
+// 当前启用的检测函数（入环部分暂时关闭，10.28 出环测试）
+#define ELEMENT_DETECTORS_ENABLED (DET_BIT(DET_PREPARE_OUT) | DET_BIT(DET_OUT_ANGLE))
+
+// 按进入调度时的状态统计检测耗时
+static PIPELINE_TLS pipeline_counter element_state_counters[ELEMENT_STATE_COUNT];
+
+void element_dispatch(void)
+{
+    const uint8_t entry_state = watch.InLoop;
+    const uint64_t t0 = pipeline_now_ns();
+    const ring_view views[2] = { ring_view_left(), ring_view_right() };
+
+    for (int i = 0; i < 2; i++) {
+        for (int d = 0; d < DET_COUNT; d++) {
+            const uint8_t s = rv_state(&views[i]);  // 前一个检测函数可能已经切换了状态
+            if (s == RING_STATE_OTHER) continue;
+            if (element_state_plan[s] & ELEMENT_DETECTORS_ENABLED & DET_BIT(d)) {
+                element_detectors[d](&views[i]);
+            }
+        }
+    }
+
+    if (entry_state < ELEMENT_STATE_COUNT) {
+        pipeline_counter_add(&element_state_counters[entry_state], pipeline_now_ns() - t0);
     }
 }
+
+const pipeline_counter *element_dispatch_counter(uint8_t state)
+{
+    return state < ELEMENT_STATE_COUNT ? &element_state_counters[state] : NULL;
+}
+
+void element_dispatch_reset_counters(void)
+{
+    for (int s = 0; s < ELEMENT_STATE_COUNT; s++) {
+        pipeline_counter_reset(&element_state_counters[s]);
+    }
+}
+
 // 默认实现：按契约 original 已是 0/255；默认直接拷贝到 imo。
 // 可选：定义 SANITIZE_INPUT 时，对非 0/255 的输入做阈值归一化。
 void process_original_to_imo(const uint8_t * RESTRICT original,
@@ -478,15 +595,11 @@ void process_original_to_imo(const uint8_t * RESTRICT original,
         memcpy(Grayscale[y], original + y * width, (size_t)width);
     }
 
-    //我的屎
-    /*
-    left_ring_first_angle();
-    left_ring_circular_arc();
-    left_ring_second_angle();
-    left_ring_begin_turn();
-    */
-    left_ring_prepare_out();
-    left_ring_out_angle();
+    PIPELINE_STAGE_RESET();
+    PIPELINE_STAGE_BEGIN();
+    //我的屎：元素检测按 InLoop 状态查表调度
+    element_dispatch();
+    PIPELINE_STAGE_MARK(PIPELINE_STAGE_ELEMENT);
     // 调用你的流水线
     image_process();
 
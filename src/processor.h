@@ -9,6 +9,8 @@
 #include <stdint.h>
 
 #include "global_image_buffer.h"
+#include "pipeline_timing.h"
+#include "ring_view.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -19,6 +21,30 @@ void process_original_to_imo(const uint8_t *original,
                              int width,
                              int height);
  void left_ring_linefix();
+#if defined(PIPELINE_THREAD_LOCAL)
+// left_ring_linefix 走的算术路径（1=Q16.16 定点，0=浮点），默认 IMAGE_USE_Q16；
+// 每条流水线各一份，GUI 的 A/B 对比按线程切换。未定义 PIPELINE_THREAD_LOCAL 时没有此变量，固定用 IMAGE_USE_Q16
+extern PIPELINE_TLS uint8_t pipeline_linefix_q16;
+#endif
+// 对给定边线数组补线；use_q16=1 走 Q16.16 定点路径，0 走浮点路径（供比对工具使用）
+void left_ring_linefix_on(uint8_t *lb, uint8_t *rb, uint8_t use_q16);
+// 在任意圆环视图上补线（左环视图或镜像的右环视图）
+void left_ring_linefix_view(const ring_view *v, uint8_t use_q16);
+
+// 圆环检测函数：均作用于视图，右环传入 ring_view_right() 即可
+void left_ring_first_angle(const ring_view *v);
+void left_ring_circular_arc(const ring_view *v);
+void left_ring_second_angle(const ring_view *v);
+void left_ring_begin_turn(const ring_view *v);
+void left_ring_prepare_out(const ring_view *v);
+void left_ring_out_angle(const ring_view *v);
+
+// 元素检测调度：按 watch.InLoop 查表，只运行当前状态需要的检测函数
+#define ELEMENT_STATE_COUNT 11  // 0 无环，1~5 左环，6~10 右环
+void element_dispatch(void);
+// 各状态的检测耗时统计（定义 PIPELINE_PROFILE 时才有耗时，否则只有次数）；越界返回 NULL
+const pipeline_counter *element_dispatch_counter(uint8_t state);
+void element_dispatch_reset_counters(void);
 
 #ifdef __cplusplus
 }
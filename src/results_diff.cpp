@@ -0,0 +1,341 @@
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <filesystem>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include "frame_results.h"
+#include "lost_bits.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define RESULTS_DIFF_SSE2 1
+#endif
+
+namespace fs = std::filesystem;
+
+// 小契约：
+// 输入：基线与候选两份结果列存（video_processor --results-store 产出的 .ipfr），
+//       或两个目录（按相对路径配对其中所有 .ipfr，例如对 data/ 下各片段分别跑两次得到的结果）；
+//       可选 --heatmap-csv P 把逐行变化次数写成 CSV
+// 行为：按 frame_id 对齐两次运行的帧，逐帧比较 l_border / r_border / center_line（SSE2 每次 16 行）、
+//       元素状态字段与 imo 哈希
+// 输出：每个片段的首个分歧帧、变化帧数、各边线变化行数与按行分段的热力图，以及两次运行的平均处理耗时；
+//       存在任何差异时退出码为 1，无法打开输入为 3，参数错误为 2
+
+namespace {
+
+constexpr int kRows = FRAME_RESULTS_ROWS;
+constexpr int kLines = 3;   // l_border / r_border / center_line
+const char *const kLineNames[kLines] = {"l_border", "r_border", "center_line"};
+
+// 按帧比较的标量字段（只比较“是否相同”，名字即列名）
+const char *const kScalarNames[] = {
+    "InLoop", "OutLoop", "cross_flag", "zebra_flag", "Straight_flag", "Curve_flag",
+    "left_lost_num", "right_lost_num", "watch_lost", "top_x", "InLoopAngle2", "OutLoopAngle1", "OutLoopAngle2",
+};
+constexpr int kScalars = (int)(sizeof(kScalarNames) / sizeof(kScalarNames[0]));
+
+// 两行 120 字节的边线，返回逐行“不相等”位图（第 y 位 = 第 y 行）
+lost_bits row_diff_mask(const uint8_t *a, const uint8_t *b) {
+    lost_bits m = {{0, 0}};
+#if RESULTS_DIFF_SSE2
+    // 7 个 16 字节块覆盖 0~111 行，最后 8 行单独用 64 位加载
+    uint64_t bits[2] = {0, 0};
+    for (int k = 0; k < 7; ++k) {
+        const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + 16 * k));
+        const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + 16 * k));
+        const uint64_t ne = (uint64_t)(~_mm_movemask_epi8(_mm_cmpeq_epi8(va, vb)) & 0xFFFF);
+        const int bit = 16 * k;
+        bits[bit >> 6] |= ne << (bit & 63);
+    }
+    const __m128i ta = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(a + 112));
+    const __m128i tb = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(b + 112));
+    bits[1] |= (uint64_t)(~_mm_movemask_epi8(_mm_cmpeq_epi8(ta, tb)) & 0xFF) << (112 - 64);
+    m.w[0] = bits[0];
+    m.w[1] = bits[1];
+#else
+    for (int y = 0; y < kRows; ++y) {
+        if (a[y] != b[y]) lost_bits_set(&m, y);
+    }
+#endif
+    return m;
+}
+
+// 一份结果列存中比对要用到的列
+struct Columns {
+    frame_results file;
+    const uint32_t *frame_id = nullptr;
+    const uint8_t *lines[kLines] = {};
+    const void *scalars[kScalars] = {};
+    const frame_results_column *scalar_cols[kScalars] = {};
+    const uint64_t *imo_hash = nullptr;
+    const uint32_t *process_us = nullptr;
+
+    Columns() { std::memset(&file, 0, sizeof(file)); }
+    ~Columns() { frame_results_close(&file); }
+    Columns(const Columns &) = delete;
+    Columns &operator=(const Columns &) = delete;
+
+    bool open(const fs::path &p, std::string &err) {
+        if (frame_results_open(&file, p.u8string().c_str()) != 0) {
+            err = "无法打开或格式不符";
+            return false;
+        }
+        frame_id = static_cast<const uint32_t *>(frame_results_array(&file, "frame_id", FRAME_RESULTS_U32, 1));
+        for (int i = 0; i < kLines; ++i) {
+            lines[i] = static_cast<const uint8_t *>(frame_results_array(&file, kLineNames[i], FRAME_RESULTS_U8, kRows));
+            if (!lines[i]) {
+                err = std::string("缺少列 ") + kLineNames[i];
+                return false;
+            }
+        }
+        if (!frame_id) {
+            err = "缺少列 frame_id";
+            return false;
+        }
+        for (int i = 0; i < kScalars; ++i) {
+            scalar_cols[i] = frame_results_find(&file, kScalarNames[i]);
+            if (scalar_cols[i] && scalar_cols[i]->count == 1) scalars[i] = frame_results_data(&file, scalar_cols[i]);
+        }
+        imo_hash = static_cast<const uint64_t *>(frame_results_array(&file, "imo_hash", FRAME_RESULTS_U64, 1));
+        process_us = static_cast<const uint32_t *>(frame_results_array(&file, "process_us", FRAME_RESULTS_U32, 1));
+        return true;
+    }
+
+    uint32_t count() const { return file.count; }
+
+    bool scalar_equal(const Columns &o, int s, uint32_t i, uint32_t j) const {
+        if (!scalars[s] || !o.scalars[s] || scalar_cols[s]->elem_bytes != o.scalar_cols[s]->elem_bytes) return true;
+        const size_t n = scalar_cols[s]->elem_bytes;
+        return std::memcmp(static_cast<const uint8_t *>(scalars[s]) + i * n,
+                           static_cast<const uint8_t *>(o.scalars[s]) + j * n, n) == 0;
+    }
+};
+
+struct DiffStats {
+    long compared = 0;
+    long only_a = 0;
+    long only_b = 0;
+    long changed_frames = 0;
+    long line_frames[kLines] = {};
+    long line_rows[kLines] = {};
+    long scalar_frames[kScalars] = {};
+    long imo_frames = 0;
+    long row_heat[kLines][kRows] = {};   // 每行在多少帧中发生变化
+    uint32_t first_frame = 0;            // 首个分歧帧的 frame_id，0 表示无
+    std::string first_what;
+    double process_us_a = 0, process_us_b = 0;
+
+    void merge(const DiffStats &o) {
+        compared += o.compared;
+        only_a += o.only_a;
+        only_b += o.only_b;
+        changed_frames += o.changed_frames;
+        imo_frames += o.imo_frames;
+        for (int l = 0; l < kLines; ++l) {
+            line_frames[l] += o.line_frames[l];
+            line_rows[l] += o.line_rows[l];
+            for (int y = 0; y < kRows; ++y) row_heat[l][y] += o.row_heat[l][y];
+        }
+        for (int s = 0; s < kScalars; ++s) scalar_frames[s] += o.scalar_frames[s];
+    }
+};
+
+// 按 frame_id 归并对齐（两侧都按帧序写入，frame_id 递增）
+void diff_files(const Columns &a, const Columns &b, DiffStats &st) {
+    uint32_t i = 0, j = 0;
+    uint64_t sum_a = 0, sum_b = 0;
+    while (i < a.count() && j < b.count()) {
+        const uint32_t fa = a.frame_id[i], fb = b.frame_id[j];
+        if (fa < fb) {
+            ++st.only_a;
+            ++i;
+            continue;
+        }
+        if (fb < fa) {
+            ++st.only_b;
+            ++j;
+            continue;
+        }
+        ++st.compared;
+        if (a.process_us && b.process_us) {
+            sum_a += a.process_us[i];
+            sum_b += b.process_us[j];
+        }
+
+        std::string what;
+        for (int l = 0; l < kLines; ++l) {
+            const lost_bits m = row_diff_mask(a.lines[l] + (size_t)i * kRows, b.lines[l] + (size_t)j * kRows);
+            const int n = lost_bits_count(&m);
+            if (n == 0) continue;
+            ++st.line_frames[l];
+            st.line_rows[l] += n;
+            for (int y = lost_bits_next(&m, 0); y >= 0; y = lost_bits_next(&m, y + 1)) ++st.row_heat[l][y];
+            if (what.empty()) what = std::string(kLineNames[l]) + " 第 " + std::to_string(lost_bits_next(&m, 0)) + " 行";
+        }
+        for (int s = 0; s < kScalars; ++s) {
+            if (a.scalar_equal(b, s, i, j)) continue;
+            ++st.scalar_frames[s];
+            if (what.empty()) what = kScalarNames[s];
+        }
+        if (a.imo_hash && b.imo_hash && a.imo_hash[i] != b.imo_hash[j]) {
+            ++st.imo_frames;
+            if (what.empty()) what = "imo";
+        }
+        if (!what.empty()) {
+            ++st.changed_frames;
+            if (st.first_frame == 0) {
+                st.first_frame = fa;
+                st.first_what = what;
+            }
+        }
+        ++i;
+        ++j;
+    }
+    st.only_a += a.count() - i;
+    st.only_b += b.count() - j;
+    if (st.compared > 0) {
+        st.process_us_a = (double)sum_a / st.compared;
+        st.process_us_b = (double)sum_b / st.compared;
+    }
+}
+
+// 热力图：每 10 行一段，显示该段内变化最多的一行在多少比例的帧中变化
+void print_heatmap(const DiffStats &st) {
+    static const char kShades[] = " .:-=+*#%@";
+    constexpr int kBand = 10;
+    std::cout << "  变化行热力图（每格 " << kBand << " 行，自 0 行起；' '=无 … '@'=几乎每帧）:" << std::endl;
+    for (int l = 0; l < kLines; ++l) {
+        std::cout << "    " << std::left << std::setw(12) << kLineNames[l] << std::right << " |";
+        for (int y0 = 0; y0 < kRows; y0 += kBand) {
+            long peak = 0;
+            for (int y = y0; y < std::min(kRows, y0 + kBand); ++y) peak = std::max(peak, st.row_heat[l][y]);
+            int shade = 0;
+            if (peak > 0) shade = 1 + (int)(peak * 8 / std::max(1L, st.compared));
+            std::cout << kShades[std::min(shade, 9)];
+        }
+        std::cout << "|" << std::endl;
+    }
+}
+
+void print_stats(const DiffStats &st, bool with_timing) {
+    std::cout << "  对齐帧: " << st.compared << "，仅基线 " << st.only_a << "，仅候选 " << st.only_b << std::endl;
+    std::cout << "  变化帧: " << st.changed_frames;
+    if (st.first_frame) std::cout << "，首个分歧帧 " << st.first_frame << "（" << st.first_what << "）";
+    std::cout << std::endl;
+    for (int l = 0; l < kLines; ++l) {
+        if (st.line_frames[l] == 0) continue;
+        std::cout << "    " << kLineNames[l] << ": " << st.line_frames[l] << " 帧，" << st.line_rows[l] << " 行" << std::endl;
+    }
+    for (int s = 0; s < kScalars; ++s) {
+        if (st.scalar_frames[s] == 0) continue;
+        std::cout << "    " << kScalarNames[s] << ": " << st.scalar_frames[s] << " 帧" << std::endl;
+    }
+    if (st.imo_frames) std::cout << "    imo: " << st.imo_frames << " 帧" << std::endl;
+    if (st.changed_frames) print_heatmap(st);
+    if (with_timing && st.process_us_a > 0) {
+        std::cout << "  平均处理耗时: 基线 " << std::fixed << std::setprecision(1) << st.process_us_a << " us，候选 "
+                  << st.process_us_b << " us（" << std::setprecision(2) << st.process_us_b / st.process_us_a << "x）"
+                  << std::endl;
+        std::cout.unsetf(std::ios::floatfield);
+    }
+}
+
+bool write_heatmap_csv(const fs::path &p, const DiffStats &st) {
+    std::ofstream f(p, std::ios::trunc);
+    f << "row";
+    for (const char *n : kLineNames) f << ',' << n;
+    f << '\n';
+    for (int y = 0; y < kRows; ++y) {
+        f << y;
+        for (int l = 0; l < kLines; ++l) f << ',' << st.row_heat[l][y];
+        f << '\n';
+    }
+    f.close();
+    return (bool)f;
+}
+
+// 两个目录按相对路径配对；单文件则直接成对
+bool collect_pairs(const fs::path &a, const fs::path &b, std::vector<std::pair<fs::path, fs::path>> &out) {
+    std::error_code ec;
+    if (!fs::is_directory(a, ec)) {
+        out.emplace_back(a, b);
+        return true;
+    }
+    if (!fs::is_directory(b, ec)) return false;
+    for (const auto &e : fs::recursive_directory_iterator(a, ec)) {
+        if (!e.is_regular_file() || e.path().extension() != ".ipfr") continue;
+        const fs::path rel = fs::relative(e.path(), a, ec);
+        out.emplace_back(e.path(), b / rel);
+    }
+    std::sort(out.begin(), out.end());
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    std::vector<fs::path> inputs;
+    fs::path heatmapCsv;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--heatmap-csv" && i + 1 < argc) {
+            heatmapCsv = fs::u8path(argv[++i]);
+        } else if (arg == "-h" || arg == "--help" || arg.rfind("--", 0) == 0) {
+            inputs.clear();
+            break;
+        } else {
+            inputs.push_back(fs::u8path(arg));
+        }
+    }
+    if (inputs.size() != 2) {
+        std::cerr << "用法: results_diff <基线.ipfr|目录> <候选.ipfr|目录> [--heatmap-csv P]" << std::endl;
+        std::cerr << "  目录             - 按相对路径配对其中所有 .ipfr" << std::endl;
+        std::cerr << "  --heatmap-csv P  - 逐行变化次数（所有片段合计）写入 CSV" << std::endl;
+        return 2;
+    }
+
+    std::vector<std::pair<fs::path, fs::path>> pairs;
+    if (!collect_pairs(inputs[0], inputs[1], pairs) || pairs.empty()) {
+        std::cerr << "错误: 未找到可配对的结果文件" << std::endl;
+        return 3;
+    }
+
+    DiffStats total;
+    bool open_failed = false;
+    for (const auto &pr : pairs) {
+        Columns a, b;
+        std::string err;
+        const fs::path *bad = !a.open(pr.first, err) ? &pr.first : !b.open(pr.second, err) ? &pr.second : nullptr;
+        if (bad) {
+            std::cerr << "错误: " << bad->u8string() << ": " << err << std::endl;
+            open_failed = true;
+            continue;
+        }
+        DiffStats st;
+        diff_files(a, b, st);
+        const bool same = st.changed_frames == 0 && st.only_a == 0 && st.only_b == 0;
+        std::cout << (same ? "[一致] " : "[变化] ") << pr.first.u8string() << std::endl;
+        print_stats(st, true);
+        total.merge(st);
+        if (total.first_frame == 0 && st.first_frame != 0) {
+            total.first_frame = st.first_frame;
+            total.first_what = pr.first.filename().u8string() + " " + st.first_what;
+        }
+    }
+
+    if (pairs.size() > 1) {
+        std::cout << "合计（" << pairs.size() << " 个片段）:" << std::endl;
+        print_stats(total, false);
+    }
+    if (!heatmapCsv.empty() && !write_heatmap_csv(heatmapCsv, total)) {
+        std::cerr << "错误: 无法写入 " << heatmapCsv << std::endl;
+        return 3;
+    }
+    if (open_failed) return 3;
+    return (total.changed_frames || total.only_a || total.only_b) ? 1 : 0;
+}
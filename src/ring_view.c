@@ -0,0 +1,39 @@
+#include "ring_view.h"
+#include "global_image_buffer.h"
+
+ring_view ring_view_make(uint8_t *lb, uint8_t *rb, const lost_bits *l_lost, const lost_bits *r_lost,
+                         uint8_t mirror)
+{
+    ring_view v;
+    v.gray = Grayscale;
+    if (!mirror) {
+        v.l = lb;
+        v.r = rb;
+        v.l_lost = l_lost;
+        v.r_lost = r_lost;
+        v.angle = &watch.InLoopAngleL;
+        v.x0 = 0;
+        v.dx = 1;
+        v.state_base = 0;
+    } else {
+        v.l = rb;
+        v.r = lb;
+        v.l_lost = r_lost;
+        v.r_lost = l_lost;
+        v.angle = &watch.InLoopAngleR;
+        v.x0 = image_w - 1;
+        v.dx = -1;
+        v.state_base = RING_RIGHT_STATE_BASE;
+    }
+    return v;
+}
+
+ring_view ring_view_left(void)
+{
+    return ring_view_make(l_border, r_border, &left_lost_bits, &right_lost_bits, 0);
+}
+
+ring_view ring_view_right(void)
+{
+    return ring_view_make(l_border, r_border, &left_lost_bits, &right_lost_bits, 1);
+}
@@ -0,0 +1,87 @@
+#ifndef RING_VIEW_H
+#define RING_VIEW_H
+
+/*
+  圆环镜像视图（零拷贝）
+
+  设计说明：
+  - 左环的检测/补线代码只通过 ring_view 访问图像与边线：视图里的“左线/右线”、列坐标、
+    状态号都由视图换算，不复制、不翻转任何一帧数据。
+  - 左环视图：列坐标原样，左线 = l_border，右线 = r_border，状态 1~5。
+  - 右环视图：列坐标 x → image_w-1-x 镜像，左线 = r_border（镜像后），右线 = l_border，
+    状态 6~10（= 左环状态 + 5）。border_min/border_max 在镜像下互换，丢线位图按行索引不变。
+  - watch 中保存列坐标的字段（top_x、InLoopAngle2_x、OutLoop_turn_point_x）一律存实际列，
+    读写时经 rv_x() 换算；rv_x 是对合映射，同一函数既用于“视图→实际”也用于“实际→视图”。
+*/
+
+#include <stdint.h>
+#include "image.h"
+#include "lost_bits.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 199901L) || defined(__cplusplus)
+  #define RV_INLINE static inline
+#else
+  #define RV_INLINE static
+#endif
+
+#define RING_STATE_COUNT 6        /* 单侧圆环状态 0~5（0 = 无环） */
+#define RING_STATE_OTHER 0xFF     /* 当前处于另一侧圆环的状态 */
+#define RING_RIGHT_STATE_BASE 5   /* 右环状态 = 左环状态 + 5 */
+
+typedef struct {
+    uint8_t (*gray)[image_w];     /* 灰度/二值图（行自上而下） */
+    uint8_t *l;                   /* 视图左线对应的实际边线数组 */
+    uint8_t *r;                   /* 视图右线对应的实际边线数组 */
+    const lost_bits *l_lost;      /* 视图左线丢线位图 */
+    const lost_bits *r_lost;      /* 视图右线丢线位图 */
+    uint8_t *angle;               /* 第一角点行：左环 InLoopAngleL，右环 InLoopAngleR */
+    int16_t x0;                   /* 列换算：实际列 = x0 + dx * 视图列 */
+    int8_t dx;
+    uint8_t state_base;           /* 状态偏移：左环 0，右环 RING_RIGHT_STATE_BASE */
+} ring_view;
+
+/* 左环视图：作用于全局 Grayscale / l_border / r_border */
+ring_view ring_view_left(void);
+/* 右环视图：同一组全局数组的镜像 */
+ring_view ring_view_right(void);
+/* 在指定边线数组上建视图（供比对/基准工具使用），mirror=1 为右环视图 */
+ring_view ring_view_make(uint8_t *lb, uint8_t *rb, const lost_bits *l_lost, const lost_bits *r_lost,
+                         uint8_t mirror);
+
+/* 视图列 ↔ 实际列 */
+RV_INLINE int rv_x(const ring_view *v, int x) { return v->x0 + v->dx * x; }
+
+/* 视图左/右线第 y 行的列坐标 */
+RV_INLINE int rv_l(const ring_view *v, int y) { return rv_x(v, v->l[y]); }
+RV_INLINE int rv_r(const ring_view *v, int y) { return rv_x(v, v->r[y]); }
+
+/* 写回视图左/右线（与原先直接赋值 uint8 数组一样截断到 8 位） */
+RV_INLINE void rv_set_l(const ring_view *v, int y, int x) { v->l[y] = (uint8_t)rv_x(v, x); }
+RV_INLINE void rv_set_r(const ring_view *v, int y, int x) { v->r[y] = (uint8_t)rv_x(v, x); }
+
+/* 视图像素：row 为图像行（自上而下），x 为视图列 */
+RV_INLINE uint8_t rv_gray(const ring_view *v, int row, int x) { return v->gray[row][rv_x(v, x)]; }
+
+/* 视图状态 0~5；处于另一侧圆环时返回 RING_STATE_OTHER */
+RV_INLINE uint8_t rv_state(const ring_view *v)
+{
+    uint8_t s = watch.InLoop;
+    if (s == 0) return 0;
+    if (s > v->state_base && s < v->state_base + RING_STATE_COUNT) return (uint8_t)(s - v->state_base);
+    return RING_STATE_OTHER;
+}
+
+RV_INLINE void rv_set_state(const ring_view *v, uint8_t s)
+{
+    watch.InLoop = s ? (uint8_t)(s + v->state_base) : 0;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RING_VIEW_H */
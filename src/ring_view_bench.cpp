@@ -0,0 +1,199 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <cstdlib>
+#include <random>
+#include <utility>
+#include "processor.h"
+#include "global_image_buffer.h"
+#include "ring_view.h"
+#include "image.h"
+#include "fixed_point.h"
+
+// 小契约：
+// 输入：可选迭代次数（默认 200000）
+// 行为：合成一帧左环图像及其左右镜像；对状态 1~5 分别
+//       (1) 用左环视图在原图上跑全部检测函数 + 补线（直接路径）；
+//       (2) 用右环视图在镜像图上跑同一套代码（镜像路径，状态号 +5）；
+//       先校验两条路径的结果互为镜像，再分别计时
+// 输出：每个状态两条路径的单帧耗时与比值；结果不一致时退出码为 1
+
+namespace {
+
+constexpr int kMirror = image_w - 1;
+
+struct Frame {
+    uint8_t gray[IMAGE_H][IMAGE_W];
+    uint8_t l[image_h];
+    uint8_t r[image_h];
+    lost_bits l_lost;
+    lost_bits r_lost;
+};
+
+// 合成左环：左线在 35~60 行丢线，其上方出现向左凸的圆弧，右线保持直道
+void synth_left_ring(Frame &f, std::mt19937 &rng) {
+    std::uniform_int_distribution<int> jitter(-1, 1);
+    lost_bits zero = {{0, 0}};
+    f.l_lost = zero;
+    f.r_lost = zero;
+    for (int y = 0; y < image_h; ++y) {
+        int l = 20 + y / 2 + jitter(rng);
+        int r = 167 - y / 2 + jitter(rng);
+        if (y >= 35 && y < 60) {
+            l = border_min;
+            lost_bits_set(&f.l_lost, y);
+        } else if (y >= 60 && y < 85) {
+            l = 20 + (y - 60) * (84 - y) / 12;
+        }
+        f.l[y] = (uint8_t)l;
+        f.r[y] = (uint8_t)r;
+    }
+    for (int y = 0; y < image_h; ++y) {
+        uint8_t *row = f.gray[image_h - 1 - y];
+        for (int x = 0; x < image_w; ++x) {
+            row[x] = (x > f.l[y] && x < f.r[y]) ? 255 : 0;
+        }
+    }
+}
+
+void mirror_frame(const Frame &src, Frame &dst) {
+    for (int row = 0; row < image_h; ++row) {
+        for (int x = 0; x < image_w; ++x) {
+            dst.gray[row][x] = src.gray[row][kMirror - x];
+        }
+    }
+    for (int y = 0; y < image_h; ++y) {
+        dst.l[y] = (uint8_t)(kMirror - src.r[y]);
+        dst.r[y] = (uint8_t)(kMirror - src.l[y]);
+    }
+    dst.l_lost = src.r_lost;
+    dst.r_lost = src.l_lost;
+}
+
+// 各状态下的 watch 初值（列坐标字段存实际列，右环场景单独镜像）
+struct watch_o scenario_watch(int state, const Frame &f) {
+    struct watch_o w = watch;
+    w.InLoop = (uint8_t)state;
+    w.InLoopAngleL = 30;
+    w.InLoopAngleR = 120;
+    w.InLoopCirc = 120;
+    w.InLoopAngle2 = (state == 2) ? 85 : 120;
+    w.InLoopAngle2_x = f.l[85];
+    w.OutLoopAngle1 = 120;
+    w.OutLoopAngle2 = 120;
+    w.OutLoop_turn_point_x = f.r[69];
+    w.zebra_flag = 0;
+    return w;
+}
+
+struct watch_o mirror_watch(struct watch_o w) {
+    if (w.InLoop) w.InLoop = (uint8_t)(w.InLoop + RING_RIGHT_STATE_BASE);
+    std::swap(w.InLoopAngleL, w.InLoopAngleR);
+    w.InLoopAngle2_x = kMirror - w.InLoopAngle2_x;
+    w.OutLoop_turn_point_x = kMirror - w.OutLoop_turn_point_x;
+    w.top_x = kMirror - w.top_x;
+    return w;
+}
+
+// 一帧：全部检测函数 + 补线（与 element_dispatch 的单视图部分一致，检测函数自带状态判断）
+void run_view(const ring_view &v) {
+    left_ring_first_angle(&v);
+    left_ring_circular_arc(&v);
+    left_ring_second_angle(&v);
+    left_ring_begin_turn(&v);
+    left_ring_prepare_out(&v);
+    left_ring_out_angle(&v);
+    left_ring_linefix_view(&v, IMAGE_USE_Q16);
+}
+
+struct PathResult {
+    uint8_t l[image_h];
+    uint8_t r[image_h];
+    struct watch_o w;
+};
+
+PathResult run_once(const Frame &f, const struct watch_o &w0, uint8_t mirror) {
+    PathResult res;
+    std::memcpy(res.l, f.l, sizeof(res.l));
+    std::memcpy(res.r, f.r, sizeof(res.r));
+    watch = w0;
+    ring_view v = ring_view_make(res.l, res.r, &f.l_lost, &f.r_lost, mirror);
+    v.gray = const_cast<uint8_t (*)[image_w]>(f.gray);
+    run_view(v);
+    res.w = watch;
+    return res;
+}
+
+bool results_mirror(const PathResult &a, const PathResult &b) {
+    for (int y = 0; y < image_h; ++y) {
+        if ((uint8_t)(kMirror - a.l[y]) != b.r[y]) return false;
+        if ((uint8_t)(kMirror - a.r[y]) != b.l[y]) return false;
+    }
+    const struct watch_o m = mirror_watch(a.w);
+    return m.InLoop == b.w.InLoop && m.InLoopAngleR == b.w.InLoopAngleR
+        && a.w.InLoopCirc == b.w.InLoopCirc && a.w.InLoopAngle2 == b.w.InLoopAngle2
+        && a.w.OutLoopAngle1 == b.w.OutLoopAngle1
+        && (uint8_t)m.InLoopAngle2_x == (uint8_t)b.w.InLoopAngle2_x;
+}
+
+double time_path(const Frame &f, const struct watch_o &w0, uint8_t mirror, long iters) {
+    uint8_t l[image_h], r[image_h];
+    ring_view v = ring_view_make(l, r, &f.l_lost, &f.r_lost, mirror);
+    v.gray = const_cast<uint8_t (*)[image_w]>(f.gray);
+    const auto t0 = std::chrono::steady_clock::now();
+    for (long i = 0; i < iters; ++i) {
+        std::memcpy(l, f.l, sizeof(l));
+        std::memcpy(r, f.r, sizeof(r));
+        watch = w0;
+        run_view(v);
+    }
+    const auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(t1 - t0).count() / (double)iters;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    long iters = 200000;
+    if (argc > 1) {
+        iters = std::atol(argv[1]);
+        if (iters <= 0) {
+            std::cerr << "用法: ring_view_bench [迭代次数]" << std::endl;
+            return 2;
+        }
+    }
+
+    std::mt19937 rng(20251028);
+    static Frame direct, mirrored;
+    synth_left_ring(direct, rng);
+    mirror_frame(direct, mirrored);
+    const struct watch_o saved = watch;
+
+    bool all_ok = true;
+    std::cout << "状态  直接路径(ns/帧)  镜像路径(ns/帧)  比值  结果" << std::endl;
+    for (int state = 1; state < RING_STATE_COUNT; ++state) {
+        const struct watch_o w_direct = scenario_watch(state, direct);
+        const struct watch_o w_mirror = mirror_watch(w_direct);
+
+        const PathResult a = run_once(direct, w_direct, 0);
+        const PathResult b = run_once(mirrored, w_mirror, 1);
+        const bool ok = results_mirror(a, b);
+        all_ok = all_ok && ok;
+
+        // 交替预热后计时，减少先后顺序带来的偏差
+        time_path(direct, w_direct, 0, iters / 10 + 1);
+        time_path(mirrored, w_mirror, 1, iters / 10 + 1);
+        const double td = time_path(direct, w_direct, 0, iters);
+        const double tm = time_path(mirrored, w_mirror, 1, iters);
+
+        std::cout << std::setw(4) << state
+                  << std::setw(17) << std::fixed << std::setprecision(1) << td
+                  << std::setw(17) << tm
+                  << std::setw(7) << std::setprecision(2) << (td > 0 ? tm / td : 0.0)
+                  << "  " << (ok ? "一致" : "不一致") << std::endl;
+    }
+    watch = saved;
+    return all_ok ? 0 : 1;
+}
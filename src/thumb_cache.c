@@ -0,0 +1,109 @@
+#include "thumb_cache.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+_Static_assert(sizeof(thumb_cache_header) == THUMB_CACHE_HEADER_BYTES, "缩略图缓存头必须是 64 字节");
+
+#define RECORD_PREFIX_BYTES 8  /* frame_index + 保留 */
+
+/* <source_path>.thumbs；调用者 free */
+static char *sidecar_path(const char *source_path)
+{
+    const size_t n = strlen(source_path);
+    char *path = (char *)malloc(n + sizeof(THUMB_CACHE_SUFFIX));
+    if (!path) return NULL;
+    memcpy(path, source_path, n);
+    memcpy(path + n, THUMB_CACHE_SUFFIX, sizeof(THUMB_CACHE_SUFFIX));
+    return path;
+}
+
+static size_t record_bytes(int width, int height)
+{
+    return RECORD_PREFIX_BYTES + (size_t)width * height * 3;
+}
+
+int thumb_cache_open(thumb_cache *c, const char *source_path, int width, int height)
+{
+    uint64_t source_bytes;
+    int64_t source_mtime;
+    memset(c, 0, sizeof(*c));
+    if (width <= 0 || height <= 0 || file_stamp_utf8(source_path, &source_bytes, &source_mtime) != 0) return -1;
+
+    char *path = sidecar_path(source_path);
+    if (!path) return -1;
+    const int rc = file_map_open(&c->map, path, THUMB_CACHE_HEADER_BYTES);
+    free(path);
+    if (rc != 0) return -1;
+
+    memcpy(&c->header, c->map.base, sizeof(c->header));
+    const thumb_cache_header *h = &c->header;
+    c->record_bytes = record_bytes(width, height);
+    if (memcmp(h->magic, THUMB_CACHE_MAGIC, 4) != 0 || h->version != THUMB_CACHE_VERSION
+        || h->header_bytes != THUMB_CACHE_HEADER_BYTES || h->width != width || h->height != height
+        || h->source_bytes != source_bytes || h->source_mtime != source_mtime
+        || (c->map.size - THUMB_CACHE_HEADER_BYTES) / c->record_bytes < h->count) {
+        thumb_cache_close(c);
+        return -1;
+    }
+    return 0;
+}
+
+void thumb_cache_close(thumb_cache *c)
+{
+    file_map_close(&c->map);
+    memset(c, 0, sizeof(*c));
+}
+
+static uint32_t record_frame(const thumb_cache *c, uint32_t i)
+{
+    uint32_t v;
+    memcpy(&v, c->map.base + THUMB_CACHE_HEADER_BYTES + (size_t)i * c->record_bytes, 4);
+    return v;
+}
+
+const uint8_t *thumb_cache_find(const thumb_cache *c, uint32_t frame_index)
+{
+    if (!c->map.base) return NULL;
+    uint32_t lo = 0, hi = c->header.count;
+    while (lo < hi) {
+        const uint32_t mid = lo + (hi - lo) / 2;
+        const uint32_t v = record_frame(c, mid);
+        if (v == frame_index) {
+            return c->map.base + THUMB_CACHE_HEADER_BYTES + (size_t)mid * c->record_bytes + RECORD_PREFIX_BYTES;
+        }
+        if (v < frame_index) lo = mid + 1;
+        else hi = mid;
+    }
+    return NULL;
+}
+
+int thumb_cache_write(const char *source_path, int width, int height, uint32_t count,
+                      const uint32_t *frame_index, const uint8_t *const *rgb)
+{
+    thumb_cache_header h;
+    memset(&h, 0, sizeof(h));
+    if (width <= 0 || height <= 0 || width > 0xFFFF || height > 0xFFFF
+        || file_stamp_utf8(source_path, &h.source_bytes, &h.source_mtime) != 0) return -1;
+    memcpy(h.magic, THUMB_CACHE_MAGIC, 4);
+    h.version = THUMB_CACHE_VERSION;
+    h.header_bytes = THUMB_CACHE_HEADER_BYTES;
+    h.width = (uint16_t)width;
+    h.height = (uint16_t)height;
+    h.count = count;
+
+    char *path = sidecar_path(source_path);
+    if (!path) return -1;
+    FILE *fp = file_open_utf8(path, "wb");
+    free(path);
+    if (!fp) return -1;
+
+    const size_t pixel_bytes = (size_t)width * height * 3;
+    int rc = fwrite(&h, sizeof(h), 1, fp) == 1 ? 0 : -1;
+    for (uint32_t i = 0; i < count && rc == 0; i++) {
+        const uint32_t prefix[2] = { frame_index[i], 0 };
+        if (fwrite(prefix, sizeof(prefix), 1, fp) != 1 || fwrite(rgb[i], pixel_bytes, 1, fp) != 1) rc = -1;
+    }
+    if (fclose(fp) != 0) rc = -1;
+    return rc;
+}
@@ -0,0 +1,61 @@
+#ifndef THUMB_CACHE_H
+#define THUMB_CACHE_H
+
+/*
+  视频缩略图旁路缓存（<视频路径>.thumbs）
+
+  文件布局（小端）：
+    [0, 64)   thumb_cache_header
+    之后逐条定长记录：frame_index（uint32）+ 保留（uint32）+ width*height*3 字节 RGB（行紧密排列）
+  - 记录按 frame_index 升序存放，读取端 mmap 后二分查找，无需解码。
+  - 头部记下源视频的字节数与修改时间；任一不符（视频被替换或改动）即视为缓存失效。
+  - 只缓存已生成的缩略图：选帧窗口中途关闭时写下的是部分结果，下次只补生成缺的。
+*/
+
+#include <stddef.h>
+#include <stdint.h>
+#include "file_map.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define THUMB_CACHE_MAGIC        "IPTH"
+#define THUMB_CACHE_VERSION      1
+#define THUMB_CACHE_HEADER_BYTES 64
+#define THUMB_CACHE_SUFFIX       ".thumbs"
+
+typedef struct {
+    char     magic[4];        /* "IPTH" */
+    uint16_t version;
+    uint16_t header_bytes;    /* 64 */
+    uint16_t width;
+    uint16_t height;
+    uint32_t count;           /* 记录数 */
+    uint64_t source_bytes;    /* 源视频字节数 */
+    int64_t  source_mtime;    /* 源视频修改时间（file_stamp_utf8） */
+    uint8_t  reserved[32];
+} thumb_cache_header;
+
+typedef struct {
+    file_map map;             /* map.base 非空即已打开 */
+    thumb_cache_header header;
+    size_t record_bytes;
+} thumb_cache;
+
+/* 打开 source_path 对应的旁路缓存；文件不存在、格式不符、缩略图尺寸不同或源视频已变返回 -1 */
+int thumb_cache_open(thumb_cache *c, const char *source_path, int width, int height);
+void thumb_cache_close(thumb_cache *c);
+
+/* 第 frame_index 帧的 RGB 像素（width*height*3 字节）；没有缓存返回 NULL */
+const uint8_t *thumb_cache_find(const thumb_cache *c, uint32_t frame_index);
+
+/* 把 count 张缩略图写成 source_path 的旁路缓存（覆盖已有文件）；frame_index 须升序。成功返回 0 */
+int thumb_cache_write(const char *source_path, int width, int height, uint32_t count,
+                      const uint32_t *frame_index, const uint8_t *const *rgb);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* THUMB_CACHE_H */
@@ -4,15 +4,48 @@
 #include <vector>
 #include <string>
 #include <cstdint>
+#include <cstring>
+#include <cstdlib>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <algorithm>
+#include <iomanip>
+#include <fstream>
+#include "bounded_queue.h"
+#include "work_stealing.h"
+#include "frame_exporter.h"
 #include "processor.h"
+#include "frame_binarize_cv.h"
+#include "luma_capture.h"
+#include "frame_archive.h"
+#include "frame_results.h"
+#include "imo_video_writer.h"
 #include "global_image_buffer.h"
+#include "image.h"
 
 namespace fs = std::filesystem;
 
 // 小契约：
-// 输入：mp4 文件路径，输出目录，可选是否仅导出 PNG 或同时调用原有处理逻辑
-// 输出：将每一帧写出为 PNG（frame_000001.png 等）；另外按 188x120 的尺寸二值化到 original 并调用 process_original_to_imo 生成 imo，可选落盘
+// 输入：mp4 文件路径（或包含 mp4 的目录，如 data/），输出目录，以及任意顺序的选项（见 kFlags / 不带参数运行时打印的用法）；
+//       --start/--end/--stride 选择帧范围与抽样步长，所有输出在同一次解码中产出
+// 输出：将每一帧写出为 PNG（frame_000001.png 等，--luma 时为灰度图；--format pnm 时为无压缩 PGM/PPM，
+//       --no-frames 时不导出原始帧）；另外按 188x120 的尺寸二值化到 original 并调用 process_original_to_imo 生成 imo，可选落盘；
+//       --imo-video 时把上色 imo（可选与源帧左右拼接）编码进单个视频，imo PNG 仅按 --imo-png-every 抽帧保留；
+//       --results-csv / --results-store 时逐帧记录结果（CSV 便于查看；列存含边线与各阶段耗时，供批量分析）；
+//       --archive 时另把每帧 188x120 二值图按位打包写入 .ipfa 归档（带帧号与时间戳）；
+//       结束时打印导出统计（文件数、字节数、编码/写盘耗时、等待内存预算的时间）
 // 异常：当视频无法打开、写盘失败、OpenCV 不存在时退出非 0
+// 并发：解码线程 → 有界队列 → 处理线程（流水线本身有跨帧状态，保持单线程顺序执行）
+//       → 导出线程池（按在途字节数限流）；文件名按帧号生成，写盘先后不影响编号
+//       输入为目录时按片段并行（--jobs），每段一条线程局部的独立流水线，线程间工作窃取；结束时打印各段 fps 汇总表
+
+// 当前线程的输出流：单段模式为 stdout/stderr；批处理模式下每段视频写入自己输出目录下的 run.log
+static thread_local std::ostream *t_out = &std::cout;
+static thread_local std::ostream *t_err = &std::cerr;
+static std::ostream &out() { return *t_out; }
+static std::ostream &err() { return *t_err; }
 
 static void ensure_dir(const fs::path &p) {
     std::error_code ec;
@@ -24,60 +57,487 @@ static void ensure_dir(const fs::path &p) {
     }
 }
 
-static void resize_and_binarize(const cv::Mat &src, std::vector<std::vector<uint8_t>> &original,
-                                int target_w, int target_h) {
-    cv::Mat gray = (src.channels() == 1) ? src : cv::Mat();
-    if (gray.empty()) {
-        cv::cvtColor(src, gray, cv::COLOR_BGR2GRAY);
+static const int TARGET_W = 188;
+static const int TARGET_H = 120;
+
+// 各阶段耗时（微秒），写入结果列存
+struct StageTimes {
+    uint32_t binarize_us = 0;
+    uint32_t process_us = 0;
+    uint32_t element_us = 0;
+    uint32_t render_us = 0;
+};
+
+static uint32_t elapsed_us(std::chrono::steady_clock::time_point t0) {
+    return (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - t0).count();
+}
+
+// 元素检测各状态累计耗时之和；前后两次相减即本帧元素检测耗时
+static uint64_t element_total_ns() {
+    uint64_t ns = 0;
+    for (uint8_t s = 0; s < ELEMENT_STATE_COUNT; ++s) ns += element_dispatch_counter(s)->total_ns;
+    return ns;
+}
+
+// 一帧 original → imo，并把 imo 上色成可视化图（0=黑，1=红，2=橙，3=黄，4=绿，5=青，255=白）
+static void process_frame(const cv::Mat &frame, cv::Mat &viz, StageTimes &times) {
+    // 缩放 + 二值化直接写入全局 original_bi_image
+    auto t0 = std::chrono::steady_clock::now();
+    if (!binarize_mat_to_original(frame)) {
+        throw std::runtime_error("不支持的帧格式");
+    }
+    times.binarize_us = elapsed_us(t0);
+
+    t0 = std::chrono::steady_clock::now();
+    const uint64_t element0 = element_total_ns();
+    // 清空全局 imo
+    for (int y = 0; y < TARGET_H; ++y) {
+        for (int x = 0; x < TARGET_W; ++x) {
+            imo[y][x] = 255;
+        }
     }
-    cv::Mat resized;
-    cv::resize(gray, resized, cv::Size(target_w, target_h), 0, 0, cv::INTER_LINEAR);
 
-    original.assign(target_h, std::vector<uint8_t>(target_w, 255));
-    for (int y = 0; y < target_h; ++y) {
-        const uint8_t *row = resized.ptr<uint8_t>(y);
-        for (int x = 0; x < target_w; ++x) {
-            original[y][x] = (row[x] > 128 ? 255 : 0);
+    process_original_to_imo(&original_bi_image[0][0], &imo[0][0], TARGET_W, TARGET_H);
+    process_original_to_imo(&original_bi_image[0][0], &imo[0][0], TARGET_W, TARGET_H);
+    times.process_us = elapsed_us(t0);
+    times.element_us = (uint32_t)((element_total_ns() - element0) / 1000);
+
+    t0 = std::chrono::steady_clock::now();
+    viz.create(TARGET_H, TARGET_W, CV_8UC3);
+    // 颜色映射表
+    static const cv::Vec3b colorMap[] = {
+        {0,0,0}, {0,0,255}, {0,165,255}, {0,255,255},
+        {0,255,0}, {255,255,0}, {255,255,255}  // 索引0-5+默认
+    };
+
+    for (int y = 0; y < TARGET_H; ++y) {
+        cv::Vec3b *row = viz.ptr<cv::Vec3b>(y);
+        for (int x = 0; x < TARGET_W; ++x) {
+            uint8_t v = imo[y][x];
+            row[x] = (v <= 5) ? colorMap[v] : colorMap[6];  // 255或其他→白色
         }
     }
+    times.render_us = elapsed_us(t0);
+}
+
+// 不带扩展名的输出路径，扩展名由导出格式决定
+static fs::path frame_stem(const fs::path &outDir, const char *prefix, int idx) {
+    char namebuf[64];
+    std::snprintf(namebuf, sizeof(namebuf), "%s_%06d", prefix, idx);
+    return outDir / namebuf;
+}
+
+// 写盘失败时的退出码：原始帧 5，imo 6；帧处理失败为 7，归档写入失败为 8，结果（CSV / 列存）写入失败为 9
+static const int EXIT_FRAME_WRITE = 5;
+static const int EXIT_IMO_WRITE = 6;
+static const int EXIT_PROCESS = 7;
+static const int EXIT_ARCHIVE_WRITE = 8;
+static const int EXIT_RESULTS_WRITE = 9;
+
+struct RunOptions {
+    bool exportFrames = true;
+    bool exportImo = false;
+    frame_archive_writer *archive = nullptr;   // 非空时逐帧追加二值图
+    ImoVideoWriter *imoVideo = nullptr;        // 非空时逐帧投递 imo 可视化
+    std::ofstream *results = nullptr;          // 非空时逐帧写一行结果 CSV
+    frame_results_writer *store = nullptr;     // 非空时逐帧追加结果列存记录
+    int imoPngEvery = 1;                       // imo PNG 每 N 帧写一张
+};
+
+static bool want_imo_png(const RunOptions &opt, int idx) {
+    return opt.exportImo && idx % opt.imoPngEvery == 0;
+}
+
+static bool needs_processing(const RunOptions &opt) {
+    return opt.exportImo || opt.imoVideo || opt.results || opt.store;
 }
 
-static void save_png(const fs::path &outPath, const cv::Mat &img) {
-    std::vector<int> params = {cv::IMWRITE_PNG_COMPRESSION, 3};
-    if (!cv::imwrite(outPath.string(), img, params)) {
-        throw std::runtime_error("写入 PNG 失败: " + outPath.string());
+// 每帧结果 CSV：帧号、时间戳与流水线结束后 watch 中的主要状态
+static void write_results_header(std::ostream &os) {
+    os << "frame_id,pts_ms,InLoop,OutLoop,cross_flag,zebra_flag,Straight_flag,Curve_flag,"
+          "left_lost_num,right_lost_num,watch_lost,top_x\n";
+}
+
+static void write_results_row(std::ostream &os, int idx, double pos_ms) {
+    os << idx << ',' << (pos_ms >= 0 ? pos_ms : -1.0) << ',' << (int)watch.InLoop << ',' << (int)watch.OutLoop << ','
+       << (int)watch.cross_flag << ',' << (int)watch.zebra_flag << ',' << (int)watch.Straight_flag << ','
+       << (int)watch.Curve_flag << ',' << (int)watch.left_lost_num << ',' << (int)watch.right_lost_num << ','
+       << watch.watch_lost << ',' << watch.top_x << '\n';
+}
+
+// 处理线程上的单帧工作：二值化 →（可选）imo 可视化、视频投递、结果行/列存 →（可选）追加归档；返回 0 或退出码
+static int process_step(const cv::Mat &frame, int idx, double pos_ms, const RunOptions &opt, cv::Mat &viz) {
+    StageTimes times;
+    try {
+        if (needs_processing(opt)) {
+            process_frame(frame, viz, times);
+        } else if (opt.archive && !binarize_mat_to_original(frame)) {
+            throw std::runtime_error("不支持的帧格式");
+        }
+    } catch (const std::exception &e) {
+        err() << "\n错误: " << e.what() << std::endl;
+        return EXIT_PROCESS;
+    }
+    if (opt.imoVideo) opt.imoVideo->push(frame, viz);
+    if (opt.results) {
+        write_results_row(*opt.results, idx, pos_ms);
+        if (!*opt.results) {
+            err() << "\n错误: 写入结果 CSV 失败" << std::endl;
+            return EXIT_RESULTS_WRITE;
+        }
+    }
+    if (opt.store) {
+        frame_results_record rec;
+        frame_results_capture(&rec);
+        rec.frame_id = (uint32_t)idx;
+        rec.pts_us = pos_ms >= 0 ? (int64_t)(pos_ms * 1000.0) : -1;
+        rec.binarize_us = times.binarize_us;
+        rec.process_us = times.process_us;
+        rec.element_us = times.element_us;
+        rec.render_us = times.render_us;
+        if (frame_results_append(opt.store, &rec) != 0) {
+            err() << "\n错误: 结果列存内存不足" << std::endl;
+            return EXIT_RESULTS_WRITE;
+        }
+    }
+    if (opt.archive) {
+        frame_archive_meta meta;
+        meta.frame_id = (uint32_t)idx;
+        meta.flags = 0;
+        meta.pts_us = pos_ms >= 0 ? (int64_t)(pos_ms * 1000.0) : -1;
+        if (frame_archive_append_u8(opt.archive, &original_bi_image[0][0], IMAGE_W, &meta) != 0) {
+            err() << "\n错误: 写入归档失败" << std::endl;
+            return EXIT_ARCHIVE_WRITE;
+        }
     }
+    return 0;
 }
 
-int main(int argc, char **argv) {
+// 帧选择：[start, end] 闭区间（帧号从 1 开始，end=0 表示到结尾），每 stride 帧取一帧
+struct FrameRange {
+    int start = 1;
+    int end = 0;
+    int stride = 1;
+
+    // 按视频总帧数估算会被选中的帧数（总帧数未知时返回 0）
+    int selected(int total) const {
+        const int last = (end > 0 && (total <= 0 || end < total)) ? end : total;
+        if (last <= 0 || last < start) return 0;
+        return (last - start) / stride + 1;
+    }
+};
+
+// 按范围/步长从视频取帧；未选中的帧只 grab（不取图、不做颜色转换）
+class FrameSelector {
+public:
+    FrameSelector(LumaCapture &cap, const FrameRange &range) : cap_(cap), range_(range) {}
+
+    // 定位到起始帧之前。POS_FRAMES 在 FFmpeg 后端会先跳到目标前最近的关键帧再解码到目标，
+    // 远比从头逐帧解码快；后端不支持定位或定位不准时，从当前位置逐帧 grab 补齐
+    bool seek_to_start() {
+        const int target = range_.start - 1;
+        if (target <= 0) return true;
+        if (cap_.set(cv::CAP_PROP_POS_FRAMES, target) && (int)cap_.get(cv::CAP_PROP_POS_FRAMES) == target) {
+            pos_ = target;
+            return true;
+        }
+        int p = (int)cap_.get(cv::CAP_PROP_POS_FRAMES);
+        if (p < 0 || p > target) {
+            cap_.set(cv::CAP_PROP_POS_FRAMES, 0);
+            p = 0;
+        }
+        for (pos_ = p; pos_ < target; ++pos_) {
+            if (!cap_.grab()) return false;
+        }
+        return true;
+    }
+
+    // 取下一帧选中的帧；idx 为其帧号
+    bool next(cv::Mat &frame, int &idx, double &pos_ms) {
+        for (;;) {
+            const int n = pos_ + 1;
+            if (range_.end > 0 && n > range_.end) return false;
+            if ((n - range_.start) % range_.stride != 0) {
+                if (!cap_.grab()) return false;
+                pos_ = n;
+                continue;
+            }
+            if (!cap_.read(frame)) return false;
+            pos_ = n;
+            idx = n;
+            pos_ms = cap_.get(cv::CAP_PROP_POS_MSEC);
+            return true;
+        }
+    }
+
+private:
+    LumaCapture &cap_;
+    FrameRange range_;
+    int pos_ = 0;   // 已消费的帧数（= 最近一帧的帧号）
+};
+
+struct DecodedFrame {
+    int idx = 0;
+    double pos_ms = -1;   // 解码后 CAP_PROP_POS_MSEC
+    cv::Mat frame;
+};
+
+class Progress {
+public:
+    explicit Progress(int total) : total_(total), interval_(std::max(1, total / 20)) {} // 每5%显示一次进度
+    void update(int done) const {
+        if (done % interval_ == 0 || done == total_) {
+            int progress = (done * 100) / std::max(1, total_);
+            out() << "\r进度: " << progress << "% (" << done << "/" << total_ << ")" << std::flush;
+        }
+    }
+
+private:
+    int total_;
+    int interval_;
+};
+
+// 单线程顺序执行（--serial，导出器不带线程，submit 内同步编码），用于对比吞吐
+static int run_serial(FrameSelector &selector, const fs::path &outDir, const RunOptions &opt,
+                      const Progress &progress, FrameExporter &exporter, int &frames) {
+    cv::Mat frame;
+    int idx = 0;
+    double pos_ms = -1;
+    frames = 0;
+    while (selector.next(frame, idx, pos_ms)) {
+        progress.update(++frames);
+        if (opt.exportFrames && !exporter.submit(frame_stem(outDir, "frame", idx), frame, EXIT_FRAME_WRITE)) break;
+        // 每帧新的 viz：--imo-video 的编码线程还持有上一帧的 Mat 头，复用缓冲会被下一帧覆盖
+        cv::Mat viz;
+        const int rc = process_step(frame, idx, pos_ms, opt, viz);
+        if (rc != 0) return rc;
+        if (want_imo_png(opt, idx) && !exporter.submit(frame_stem(outDir, "imo", idx), viz, EXIT_IMO_WRITE)) break;
+    }
+    return 0;
+}
+
+// 解码 / 处理 / 导出三级流水线
+static int run_pipelined(FrameSelector &selector, const fs::path &outDir, const RunOptions &opt,
+                         const Progress &progress, FrameExporter &exporter, int &frames) {
+    BoundedQueue<DecodedFrame> decoded(8);
+    std::atomic<bool> stop{false};
+
+    std::thread decoder([&] {
+        while (!stop.load()) {
+            DecodedFrame item;
+            if (!selector.next(item.frame, item.idx, item.pos_ms)) break;
+            if (!decoded.push(std::move(item))) break;
+        }
+        decoded.close();
+    });
+
+    // 处理线程（调用线程）：流水线有跨帧状态，必须按帧序单线程执行
+    int rc = 0;
+    frames = 0;
+    DecodedFrame item;
+    while (decoded.pop(item)) {
+        progress.update(++frames);
+
+        cv::Mat viz;
+        rc = process_step(item.frame, item.idx, item.pos_ms, opt, viz);
+        if (rc != 0) break;
+        if (opt.exportFrames && !exporter.submit(frame_stem(outDir, "frame", item.idx),
+                                                 std::move(item.frame), EXIT_FRAME_WRITE)) break;
+        if (want_imo_png(opt, item.idx) && !exporter.submit(frame_stem(outDir, "imo", item.idx),
+                                              std::move(viz), EXIT_IMO_WRITE)) break;
+    }
+
+    stop.store(true);
+    decoded.close();
+    decoder.join();
+    return rc;
+}
+
+static void print_export_stats(const ExportStats &st) {
+    out() << "导出文件: " << st.files << " 个，" << std::fixed << std::setprecision(1)
+              << st.bytes / (1024.0 * 1024.0) << " MB" << std::endl;
+    out() << "编码耗时: " << st.encode_ms << " ms，写盘耗时: " << st.write_ms
+              << " ms（各线程累计），等待内存预算: " << st.stall_ms << " ms" << std::endl;
+    out().unsetf(std::ios::floatfield);
+}
+
+// ---------------- 命令行 ----------------
+
+struct CliOptions {
+    fs::path input;
+    fs::path outDir;
+    RunOptions run;
+    ExportOptions exportOpt;
+    FrameRange range;
+    ImoVideoOptions imoVideo;
+    std::string archivePath;
+    std::string resultsPath;
+    std::string storePath;
+    bool serial = false;
+    bool lumaOnly = false;
+    int encoders = 1;
+    int jobs = 0;   // 批处理并行片段数，0 = CPU 核数
+};
+
+static bool parse_int(const char *v, int lo, int hi, int &out) {
+    char *end = nullptr;
+    const long n = std::strtol(v, &end, 10);
+    if (end == v || *end != '\0' || n < lo || n > hi) return false;
+    out = (int)n;
+    return true;
+}
+
+// 选项表：同一张表用于解析和打印用法；arg 为 nullptr 表示开关
+struct CliFlag {
+    const char *name;
+    const char *arg;
+    const char *help;
+    bool (*apply)(CliOptions &o, const char *v);   // 参数值非法时返回 false
+};
+
+static const CliFlag kFlags[] = {
+    // 帧选择
+    {"--start", "N", "从第 N 帧开始（帧号从 1 起；借助关键帧定位，不从头解码）",
+     [](CliOptions &o, const char *v) { return parse_int(v, 1, INT32_MAX, o.range.start); }},
+    {"--end", "N", "处理到第 N 帧为止（含），默认到结尾",
+     [](CliOptions &o, const char *v) { return parse_int(v, 1, INT32_MAX, o.range.end); }},
+    {"--stride", "K", "每 K 帧取一帧（跳过的帧不取图）；注意元素状态机按抽样后的帧推进",
+     [](CliOptions &o, const char *v) { return parse_int(v, 1, INT32_MAX, o.range.stride); }},
+    // 输出
+    {"--no-frames", nullptr, "不导出原始帧",
+     [](CliOptions &o, const char *) { o.run.exportFrames = false; return true; }},
+    {"--export-imo", nullptr, "导出上色后的 imo 图像",
+     [](CliOptions &o, const char *) { o.run.exportImo = true; return true; }},
+    {"--imo-png-every", "N", "与 --export-imo 同用时每 N 帧才写一张 imo 图像，默认 1",
+     [](CliOptions &o, const char *v) { return parse_int(v, 1, INT32_MAX, o.run.imoPngEvery); }},
+    {"--imo-video", "P", "把上色 imo 写成单个视频 P（独立编码线程）",
+     [](CliOptions &o, const char *v) { o.imoVideo.path = v; return true; }},
+    {"--imo-fourcc", "C", "视频编码 fourcc，默认 MJPG；raw 为不压缩",
+     [](CliOptions &o, const char *v) { o.imoVideo.fourcc = v; return o.imoVideo.fourcc == "raw" || o.imoVideo.fourcc.size() == 4; }},
+    {"--imo-scale", "N", "imo 视频放大倍数，默认 2",
+     [](CliOptions &o, const char *v) { return parse_int(v, 1, 16, o.imoVideo.scale); }},
+    {"--side-by-side", nullptr, "imo 视频左侧拼接源帧",
+     [](CliOptions &o, const char *) { o.imoVideo.side_by_side = true; return true; }},
+    {"--results-csv", "P", "每帧一行处理结果（帧号、时间戳、元素状态、丢线数等）写入 CSV 文件 P",
+     [](CliOptions &o, const char *v) { o.resultsPath = v; return true; }},
+    {"--results-store", "P", "每帧边线、丢线位图、元素状态与各阶段耗时写入列存文件 P（.ipfr，可 mmap 整列读取）",
+     [](CliOptions &o, const char *v) { o.storePath = v; return true; }},
+    {"--archive", "P", "把每帧二值图位打包写入归档文件 P（GUI 可直接打开、按帧随机访问）",
+     [](CliOptions &o, const char *v) { o.archivePath = v; return true; }},
+    // 导出格式
+    {"--format", "F", "png（默认）或 pnm（无压缩 PGM/PPM，最省 CPU）",
+     [](CliOptions &o, const char *v) {
+         const std::string f = v;
+         if (f == "png") o.exportOpt.format = ExportFormat::Png;
+         else if (f == "pnm") o.exportOpt.format = ExportFormat::Pnm;
+         else return false;
+         return true;
+     }},
+    {"--png-level", "N", "PNG 压缩级别 0~9，默认 3；0 为不压缩",
+     [](CliOptions &o, const char *v) { return parse_int(v, 0, 9, o.exportOpt.png_level); }},
+    {"--export-budget", "MB", "待导出图像的在途内存上限，默认 256",
+     [](CliOptions &o, const char *v) {
+         int mb = 0;
+         if (!parse_int(v, 1, 1 << 20, mb)) return false;
+         o.exportOpt.budget_bytes = (std::size_t)mb << 20;
+         return true;
+     }},
+    // 执行方式
+    {"--encoders", "N", "导出（编码+写盘）线程数，默认 CPU 核数-2（至少 1）",
+     [](CliOptions &o, const char *v) { return parse_int(v, 1, 256, o.encoders); }},
+    {"--serial", nullptr, "单线程顺序执行，用于对比吞吐",
+     [](CliOptions &o, const char *) { o.serial = true; return true; }},
+    {"--jobs", "N", "输入为目录时同时处理的片段数，默认 CPU 核数",
+     [](CliOptions &o, const char *v) { return parse_int(v, 1, 256, o.jobs); }},
+    {"--luma", nullptr, "只解码亮度平面，跳过 YUV→BGR 转换；后端不支持时自动退回 BGR",
+     [](CliOptions &o, const char *) { o.lumaOnly = true; return true; }},
+};
+
+static void print_usage() {
+    err() << "用法: video_processor <input.mp4|目录> <output_dir> [选项...]" << std::endl;
+    err() << "  一次解码同时产出所有选中的输出（原始帧 / imo 图像 / imo 视频 / 结果 CSV / 归档）" << std::endl;
+    err() << "  输入为目录时批处理其下所有 mp4：每段输出到 <output_dir>/<相对路径>/<片段名>/，" << std::endl;
+    err() << "  文件类选项只取文件名放入各段目录，各段日志写入该目录下的 run.log" << std::endl;
+    for (const CliFlag &f : kFlags) {
+        std::string head = f.name;
+        if (f.arg) head += std::string(" ") + f.arg;
+        err() << "  " << std::left << std::setw(20) << head << " " << f.help << std::endl;
+    }
+}
+
+// 返回 0 表示成功；否则为退出码
+static int parse_args(int argc, char **argv, CliOptions &o) {
     if (argc < 3) {
-        std::cerr << "用法: video_processor <input.mp4> <output_dir> [--export-imo]" << std::endl;
-        std::cerr << "  input.mp4   - 输入视频文件路径" << std::endl;
-        std::cerr << "  output_dir  - 输出目录路径" << std::endl;
-        std::cerr << "  --export-imo - (可选) 同时导出处理后的imo图像" << std::endl;
+        print_usage();
         return 2;
     }
-    
-    const fs::path input = argv[1];
-    const fs::path outDir = argv[2];
-    const bool exportImo = (argc >= 4 && std::string(argv[3]) == "--export-imo");
+    o.input = argv[1];
+    o.outDir = argv[2];
+    const unsigned hw = std::thread::hardware_concurrency();
+    o.encoders = hw > 3 ? (int)hw - 2 : 1;
+
+    for (int i = 3; i < argc; ++i) {
+        const CliFlag *flag = nullptr;
+        for (const CliFlag &f : kFlags) {
+            if (std::strcmp(argv[i], f.name) == 0) {
+                flag = &f;
+                break;
+            }
+        }
+        if (!flag) {
+            err() << "错误: 未知参数: " << argv[i] << std::endl;
+            return 2;
+        }
+        const char *value = nullptr;
+        if (flag->arg) {
+            if (i + 1 >= argc) {
+                err() << "错误: " << flag->name << " 缺少参数 " << flag->arg << std::endl;
+                return 2;
+            }
+            value = argv[++i];
+        }
+        if (!flag->apply(o, value)) {
+            err() << "错误: " << flag->name << " 的参数非法: " << (value ? value : "") << std::endl;
+            return 2;
+        }
+    }
+    if (o.range.end > 0 && o.range.end < o.range.start) {
+        err() << "错误: --end 不能小于 --start" << std::endl;
+        return 2;
+    }
+    return 0;
+}
+
+// 一段视频的运行结果（批处理汇总用）
+struct ClipReport {
+    int rc = 0;
+    int frames = 0;
+    double seconds = 0;
+};
+
+// 处理一段视频；返回退出码
+static int run_clip(CliOptions &cli, ClipReport &report) {
+    RunOptions &opt = cli.run;
+    ExportOptions &exportOpt = cli.exportOpt;
+    const fs::path &input = cli.input;
+    const fs::path &outDir = cli.outDir;
     
     // 验证输入文件
     if (!fs::exists(input)) {
-        std::cerr << "错误: 输入文件不存在: " << input << std::endl;
+        err() << "错误: 输入文件不存在: " << input << std::endl;
         return 1;
     }
 
     try {
         ensure_dir(outDir);
     } catch (const std::exception &e) {
-        std::cerr << "错误: " << e.what() << std::endl;
+        err() << "错误: " << e.what() << std::endl;
         return 3;
     }
 
-    cv::VideoCapture cap(input.string());
-    if (!cap.isOpened()) {
-        std::cerr << "错误: 无法打开视频: " << input << std::endl;
+    LumaCapture cap;
+    if (!cap.open(input.string(), cli.lumaOnly)) {
+        err() << "错误: 无法打开视频: " << input << std::endl;
         return 4;
     }
     
@@ -87,96 +547,301 @@ int main(int argc, char **argv) {
     int width = static_cast<int>(cap.get(cv::CAP_PROP_FRAME_WIDTH));
     int height = static_cast<int>(cap.get(cv::CAP_PROP_FRAME_HEIGHT));
     
-    std::cout << "视频信息:" << std::endl;
-    std::cout << "  分辨率: " << width << "x" << height << std::endl;
-    std::cout << "  帧率: " << fps << " fps" << std::endl;
-    std::cout << "  总帧数: " << total_frames << std::endl;
-    std::cout << "  输出目录: " << outDir << std::endl;
-    if (exportImo) {
-        std::cout << "  处理模式: 导出原始帧 + imo处理结果" << std::endl;
+    out() << "视频信息:" << std::endl;
+    out() << "  分辨率: " << width << "x" << height << std::endl;
+    out() << "  帧率: " << fps << " fps" << std::endl;
+    out() << "  总帧数: " << total_frames << std::endl;
+    out() << "  输出目录: " << outDir << std::endl;
+    if (cli.range.start > 1 || cli.range.end > 0 || cli.range.stride > 1) {
+        out() << "  帧范围: " << cli.range.start << " ~ " << (cli.range.end > 0 ? std::to_string(cli.range.end) : "结尾")
+                  << "，步长 " << cli.range.stride << std::endl;
+    }
+    out() << "  输出:";
+    if (opt.exportFrames) out() << " 原始帧";
+    if (opt.exportImo) out() << " imo图像";
+    if (!cli.imoVideo.path.empty()) out() << " imo视频";
+    if (!cli.resultsPath.empty()) out() << " 结果CSV";
+    if (!cli.storePath.empty()) out() << " 结果列存";
+    if (!cli.archivePath.empty()) out() << " 归档";
+    out() << std::endl;
+    if (exportOpt.format == ExportFormat::Png) {
+        out() << "  导出格式: PNG（压缩级别 " << exportOpt.png_level << "）" << std::endl;
     } else {
-        std::cout << "  处理模式: 仅导出原始帧" << std::endl;
+        out() << "  导出格式: PGM/PPM（无压缩）" << std::endl;
+    }
+    if (cli.serial) {
+        out() << "  执行方式: 单线程" << std::endl;
+    } else {
+        out() << "  执行方式: 流水线（导出线程 " << cli.encoders << "，在途上限 "
+                  << (exportOpt.budget_bytes >> 20) << " MB）" << std::endl;
+    }
+    if (cli.lumaOnly) {
+        out() << "  解码方式: " << (cap.luma() ? "仅亮度平面" : "后端不支持仅亮度，已退回 BGR") << std::endl;
     }
-    std::cout << std::endl;
 
-    const int TARGET_W = 188;
-    const int TARGET_H = 120;
+    frame_archive_writer archive;
+    if (!cli.archivePath.empty()) {
+        if (frame_archive_create(&archive, cli.archivePath.c_str(), TARGET_W, TARGET_H, sizeof(frame_archive_meta)) != 0) {
+            err() << "错误: 无法创建归档: " << cli.archivePath << std::endl;
+            return 3;
+        }
+        opt.archive = &archive;
+        out() << "  归档文件: " << cli.archivePath << std::endl;
+    }
+    // 开始处理前的提前返回：归档与列存里还没有帧，关闭并删除（--batch 下每段都会走到这里）
+    auto discard_outputs = [&opt] {
+        if (opt.archive) frame_archive_abort(opt.archive);
+        if (opt.store) frame_results_abort(opt.store);
+    };
 
-    cv::Mat frame;
-    int idx = 0;
-    int progress_interval = std::max(1, total_frames / 20); // 每5%显示一次进度
-    
-    std::cout << "开始处理..." << std::endl;
-    
-    while (true) {
-        if (!cap.read(frame)) break;
-        ++idx;
-        
-        // 显示进度
-        if (idx % progress_interval == 0 || idx == total_frames) {
-            int progress = (idx * 100) / std::max(1, total_frames);
-            std::cout << "\r进度: " << progress << "% (" << idx << "/" << total_frames << ")" << std::flush;
-        }
-
-        // 导出原始帧 PNG（按原分辨率）
-        char namebuf[64];
-        std::snprintf(namebuf, sizeof(namebuf), "frame_%06d.png", idx);
-        fs::path outPng = outDir / namebuf;
-        try {
-            save_png(outPng, frame);
-        } catch (const std::exception &e) {
-            std::cerr << "\n错误: " << e.what() << std::endl;
-            return 5;
-        }
-
-        // 转换成 188x120 二值 original，并调用现有 C 处理逻辑，选择性落盘
-        if (exportImo) {
-            std::vector<std::vector<uint8_t>> original;
-            resize_and_binarize(frame, original, TARGET_W, TARGET_H);
-            
-            // 拷贝到全局 original_bi_image
-            for (int y = 0; y < TARGET_H; ++y) {
-                memcpy(original_bi_image[y], original[y].data(), TARGET_W);
-            }
-            
-            // 清空全局 imo
-            for (int y = 0; y < TARGET_H; ++y) {
-                for (int x = 0; x < TARGET_W; ++x) {
-                    imo[y][x] = 255;
-                }
-            }
-            
-            process_original_to_imo(&original_bi_image[0][0], &imo[0][0], TARGET_W, TARGET_H);
-            process_original_to_imo(&original_bi_image[0][0], &imo[0][0], TARGET_W, TARGET_H);
-            
-            // 将 imo 可视化落盘为彩色 PNG（0=黑，1=红，2=橙，3=黄，4=绿，5=青，255=白）
-            cv::Mat viz(TARGET_H, TARGET_W, CV_8UC3);
-            // 颜色映射表
-            static const cv::Vec3b colorMap[] = {
-                {0,0,0}, {0,0,255}, {0,165,255}, {0,255,255}, 
-                {0,255,0}, {255,255,0}, {255,255,255}  // 索引0-5+默认
-            };
-            
-            for (int y = 0; y < TARGET_H; ++y) {
-                cv::Vec3b *row = viz.ptr<cv::Vec3b>(y);
-                for (int x = 0; x < TARGET_W; ++x) {
-                    uint8_t v = imo[y][x];
-                    row[x] = (v <= 5) ? colorMap[v] : colorMap[6];  // 255或其他→白色
-                }
-            }
-            std::snprintf(namebuf, sizeof(namebuf), "imo_%06d.png", idx);
-            fs::path outImo = outDir / namebuf;
-            try {
-                save_png(outImo, viz);
-            } catch (const std::exception &e) {
-                std::cerr << "\n错误: " << e.what() << std::endl;
-                return 6;
-            }
+    ImoVideoWriter imoVideo;
+    if (!cli.imoVideo.path.empty()) {
+        cli.imoVideo.fps = fps / cli.range.stride;
+        cli.imoVideo.source_size = cv::Size(width, height);
+        if (!imoVideo.open(cli.imoVideo)) {
+            err() << "错误: 无法创建 imo 视频（检查 fourcc 与扩展名）: " << cli.imoVideo.path << std::endl;
+            discard_outputs();
+            return 3;
         }
+        opt.imoVideo = &imoVideo;
+        out() << "  imo 视频: " << cli.imoVideo.path << " (" << imoVideo.frame_size().width << "x"
+                  << imoVideo.frame_size().height << ", " << cli.imoVideo.fourcc << ")" << std::endl;
     }
+
+    std::ofstream results;
+    if (!cli.resultsPath.empty()) {
+        results.open(fs::u8path(cli.resultsPath), std::ios::trunc);
+        if (!results) {
+            err() << "错误: 无法创建结果 CSV: " << cli.resultsPath << std::endl;
+            discard_outputs();
+            return 3;
+        }
+        write_results_header(results);
+        opt.results = &results;
+        out() << "  结果 CSV: " << cli.resultsPath << std::endl;
+    }
+    frame_results_writer store;
+    if (!cli.storePath.empty()) {
+        if (frame_results_create(&store, cli.storePath.c_str()) != 0) {
+            err() << "错误: 无法创建结果列存: " << cli.storePath << std::endl;
+            discard_outputs();
+            return 3;
+        }
+        opt.store = &store;
+        out() << "  结果列存: " << cli.storePath << std::endl;
+    }
+    out() << std::endl;
+
+    FrameSelector selector(cap, cli.range);
+    if (!selector.seek_to_start()) {
+        err() << "错误: 无法定位到第 " << cli.range.start << " 帧" << std::endl;
+        discard_outputs();
+        return 4;
+    }
+
+    const Progress progress(cli.range.selected(total_frames));
+    int done = 0;
     
-    std::cout << "\n完成！" << std::endl;
-    std::cout << "导出帧数: " << idx << std::endl;
-    std::cout << "输出目录: " << outDir << std::endl;
+    out() << "开始处理..." << std::endl;
+    const auto t0 = std::chrono::steady_clock::now();
+    exportOpt.workers = cli.serial ? 0 : cli.encoders;
+    FrameExporter exporter(exportOpt);
+    const int rc = cli.serial ? run_serial(selector, outDir, opt, progress, exporter, done)
+                              : run_pipelined(selector, outDir, opt, progress, exporter, done);
+    exporter.finish();
+    imoVideo.finish();
+    const bool archived = !opt.archive || frame_archive_finish(opt.archive) == 0;
+    // 处理、导出或归档任一失败都只丢弃临时列存，不覆盖 storePath 上原有的结果
+    if (opt.store && (rc != 0 || exporter.failed() || !archived)) {
+        frame_results_abort(opt.store);
+        opt.store = nullptr;
+    }
+    if (!archived && rc == 0) {
+        err() << "\n错误: 写入归档失败: " << cli.archivePath << std::endl;
+        return EXIT_ARCHIVE_WRITE;
+    }
+    if (opt.store && frame_results_finish(opt.store) != 0) {
+        err() << "\n错误: 写入结果列存失败: " << cli.storePath << std::endl;
+        return EXIT_RESULTS_WRITE;
+    }
+    if (opt.results) {
+        results.close();
+        if (!results && rc == 0) {
+            err() << "\n错误: 写入结果 CSV 失败: " << cli.resultsPath << std::endl;
+            return EXIT_RESULTS_WRITE;
+        }
+    }
+    if (rc != 0) return rc;
+    if (exporter.failed()) {
+        err() << "\n错误: " << exporter.error_message() << std::endl;
+        return exporter.error_code();
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    report.frames = done;
+    report.seconds = seconds;
+
+    out() << "\n完成！" << std::endl;
+    out() << "处理帧数: " << done << std::endl;
+    out() << "输出目录: " << outDir << std::endl;
+    out() << "耗时: " << seconds << " s，吞吐: " << (seconds > 0 ? done / seconds : 0.0) << " 帧/秒" << std::endl;
+    print_export_stats(exporter.stats());
+    if (opt.imoVideo) {
+        out() << "imo 视频: " << imoVideo.frames() << " 帧，拼接+编码耗时 " << std::fixed << std::setprecision(1)
+                  << imoVideo.encode_ms() << " ms" << std::endl;
+        out().unsetf(std::ios::floatfield);
+    }
     return 0;
 }
+
+// ---------------- 批处理 ----------------
+
+static void collect_clips(const fs::path &p, std::vector<fs::path> &out) {
+    std::error_code ec;
+    for (const auto &e : fs::recursive_directory_iterator(p, ec)) {
+        if (e.is_regular_file() && e.path().extension() == ".mp4") out.push_back(e.path());
+    }
+}
+
+// 批处理中某段视频的选项：输出目录按相对路径展开，文件类选项只取文件名放进该目录；
+// 各段在自己的线程里顺序执行（不再另开解码/导出线程），并行度来自多段同时处理：
+// --jobs 已按核数开满工作线程，每段再开解码线程和导出线程池只会超额订阅、互相抢核。
+// --imo-video 的编码线程照常每段一条；run_serial 每帧用新的 viz，入队的帧不会被覆盖
+static CliOptions clip_options(const CliOptions &base, const fs::path &root, const fs::path &clip) {
+    CliOptions o = base;
+    o.input = clip;
+    std::error_code ec;
+    o.outDir = base.outDir / fs::relative(clip.parent_path(), root, ec) / clip.stem();
+    for (std::string *p : {&o.imoVideo.path, &o.archivePath, &o.resultsPath, &o.storePath}) {
+        if (!p->empty()) *p = (o.outDir / fs::u8path(*p).filename()).u8string();
+    }
+    o.serial = true;
+    return o;
+}
+
+// 按显示宽度补齐到 width 列（UTF-8 中文按 2 列计），用于对齐汇总表中的中文列
+static std::string pad_display(const std::string &text, int width, bool left_align) {
+    int cols = 0;
+    for (std::size_t i = 0; i < text.size(); ++i) {
+        const unsigned char c = (unsigned char)text[i];
+        if ((c & 0xC0) == 0x80) continue;   // 续字节
+        cols += c >= 0xE0 ? 2 : 1;
+    }
+    const std::string fill(cols < width ? (std::size_t)(width - cols) : 0, ' ');
+    return left_align ? text + fill : fill + text;
+}
+
+struct BatchTask {
+    std::size_t index = 0;
+    std::uintmax_t bytes = 0;   // 文件大小，近似片段长度
+};
+
+struct BatchResult {
+    ClipReport report;
+    std::size_t worker = 0;
+    bool stolen = false;
+};
+
+static int run_batch(const CliOptions &cli) {
+    std::vector<fs::path> clips;
+    collect_clips(cli.input, clips);
+    std::sort(clips.begin(), clips.end());
+    if (clips.empty()) {
+        err() << "错误: 目录下没有 mp4 片段: " << cli.input << std::endl;
+        return 1;
+    }
+
+    // 片段长短不一（几百到几千帧）：按文件大小从大到小轮流分给各线程，先做长片段，
+    // 做完自己的再从别的线程队列尾部偷短片段，避免最后只剩一个线程在跑长片段
+    std::vector<BatchTask> tasks(clips.size());
+    for (std::size_t i = 0; i < clips.size(); ++i) {
+        std::error_code ec;
+        tasks[i].index = i;
+        tasks[i].bytes = fs::file_size(clips[i], ec);
+    }
+    std::sort(tasks.begin(), tasks.end(), [](const BatchTask &a, const BatchTask &b) { return a.bytes > b.bytes; });
+
+    const unsigned hw = std::thread::hardware_concurrency();
+    const std::size_t jobs = std::min<std::size_t>(clips.size(), cli.jobs > 0 ? (std::size_t)cli.jobs : std::max(1u, hw));
+    WorkStealingQueues<BatchTask> queues(jobs);
+    queues.seed(tasks);
+    std::vector<BatchResult> results(clips.size());
+
+    // 按片段并行，关闭 OpenCV 内部的线程池以免超额订阅
+    cv::setNumThreads(1);
+    out() << "批处理: " << clips.size() << " 个片段，并行 " << jobs << " 路，输出目录 " << cli.outDir << std::endl;
+
+    std::mutex print_mutex;
+    std::size_t finished = 0;
+    const auto t0 = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (std::size_t w = 0; w < jobs; ++w) {
+        workers.emplace_back([&, w] {
+            BatchTask task;
+            bool stolen = false;
+            while (queues.take(w, task, &stolen)) {
+                BatchResult &res = results[task.index];
+                res.worker = w;
+                res.stolen = stolen;
+                // 每段在新线程里跑：线程局部的算法状态与动态日志都从初始值开始，
+                // 结果与单独运行一次 video_processor 相同
+                std::thread([&] {
+                    CliOptions o = clip_options(cli, cli.input, clips[task.index]);
+                    std::error_code ec;
+                    fs::create_directories(o.outDir, ec);
+                    std::ofstream log(o.outDir / "run.log", std::ios::trunc);
+                    if (log) {
+                        t_out = &log;
+                        t_err = &log;
+                    }
+                    res.report.rc = run_clip(o, res.report);
+                }).join();
+
+                std::lock_guard<std::mutex> lock(print_mutex);
+                ++finished;
+                out() << "[" << finished << "/" << clips.size() << "] " << (res.report.rc == 0 ? "完成 " : "失败 ")
+                      << clips[task.index].u8string() << std::endl;
+            }
+        });
+    }
+    for (auto &t : workers) t.join();
+    const double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    // 汇总表
+    int rc = 0;
+    long total_frames = 0;
+    double busy = 0;
+    out() << "\n" << pad_display("片段", 40, true) << pad_display("帧数", 8, false) << pad_display("耗时(s)", 10, false)
+          << pad_display("帧/秒", 10, false) << pad_display("线程", 6, false) << "  状态" << std::endl;
+    out() << std::fixed;
+    for (std::size_t i = 0; i < clips.size(); ++i) {
+        const BatchResult &r = results[i];
+        std::error_code ec;
+        const std::string name = fs::relative(clips[i], cli.input, ec).u8string();
+        out() << pad_display(name, 40, true) << std::setw(8) << r.report.frames << std::setprecision(2)
+              << std::setw(10) << r.report.seconds << std::setprecision(1) << std::setw(10)
+              << (r.report.seconds > 0 ? r.report.frames / r.report.seconds : 0.0) << std::setw(6) << r.worker
+              << (r.stolen ? "* " : "  ");
+        if (r.report.rc == 0) {
+            out() << "成功" << std::endl;
+        } else {
+            out() << "退出码 " << r.report.rc << "（见 run.log）" << std::endl;
+            if (rc == 0) rc = r.report.rc;
+        }
+        total_frames += r.report.frames;
+        busy += r.report.seconds;
+    }
+    out() << "合计: " << total_frames << " 帧，墙钟 " << std::setprecision(2) << wall << " s，总吞吐 " << std::setprecision(1)
+          << (wall > 0 ? total_frames / wall : 0.0) << " 帧/秒，线程利用率 " << (wall > 0 ? 100.0 * busy / (wall * jobs) : 0.0)
+          << "%，窃取 " << queues.steals() << " 次（* 为偷来的片段）" << std::endl;
+    out().unsetf(std::ios::floatfield);
+    return rc;
+}
+
+int main(int argc, char **argv) {
+    CliOptions cli;
+    if (const int rc = parse_args(argc, argv, cli)) return rc;
+    std::error_code ec;
+    if (fs::is_directory(cli.input, ec)) return run_batch(cli);
+    ClipReport report;
+    return run_clip(cli, report);
+}
@@ -0,0 +1,79 @@
+#ifndef WORK_STEALING_H
+#define WORK_STEALING_H
+
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+// 粗粒度任务的工作窃取队列（每个工作线程一条双端队列）
+// - 任务在开始前一次性分配好（seed 轮流分给各线程），运行中不再新增
+// - take：先从自己队列的头部取；自己的空了再依次从其他线程队列的尾部偷
+//   调用者按“大任务在前”排好序再 seed，则各线程先做大任务，偷走的是剩下的小任务
+// - 每条队列各有一把锁：任务是整段视频这种秒级的工作，锁开销可忽略，无需无锁实现
+template <typename T>
+class WorkStealingQueues {
+public:
+    explicit WorkStealingQueues(std::size_t workers) : queues_(workers ? workers : 1) {}
+
+    WorkStealingQueues(const WorkStealingQueues &) = delete;
+    WorkStealingQueues &operator=(const WorkStealingQueues &) = delete;
+
+    std::size_t workers() const { return queues_.size(); }
+
+    // 按顺序轮流分给各线程
+    void seed(std::vector<T> items) {
+        for (std::size_t i = 0; i < items.size(); ++i) {
+            Queue &q = queues_[i % queues_.size()];
+            std::lock_guard<std::mutex> lock(q.mutex);
+            q.items.push_back(std::move(items[i]));
+        }
+    }
+
+    // 取下一个任务；所有队列都空时返回 false。stolen 表示该任务是否偷自其他线程
+    bool take(std::size_t worker, T &out, bool *stolen = nullptr) {
+        if (pop_front(queues_[worker], out)) {
+            if (stolen) *stolen = false;
+            return true;
+        }
+        for (std::size_t k = 1; k < queues_.size(); ++k) {
+            if (pop_back(queues_[(worker + k) % queues_.size()], out)) {
+                steals_.fetch_add(1, std::memory_order_relaxed);
+                if (stolen) *stolen = true;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::size_t steals() const { return steals_.load(std::memory_order_relaxed); }
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<T> items;
+    };
+
+    static bool pop_front(Queue &q, T &out) {
+        std::lock_guard<std::mutex> lock(q.mutex);
+        if (q.items.empty()) return false;
+        out = std::move(q.items.front());
+        q.items.pop_front();
+        return true;
+    }
+
+    static bool pop_back(Queue &q, T &out) {
+        std::lock_guard<std::mutex> lock(q.mutex);
+        if (q.items.empty()) return false;
+        out = std::move(q.items.back());
+        q.items.pop_back();
+        return true;
+    }
+
+    std::vector<Queue> queues_;
+    std::atomic<std::size_t> steals_{0};
+};
+
+#endif // WORK_STEALING_H